@@ -0,0 +1,216 @@
+﻿/**********************************************************************************************//**
+ * @file    KinematicsBenchmarks.cs
+ *
+ * @brief   Implements the kinematics benchmarks class.
+ **************************************************************************************************/
+
+using BenchmarkDotNet.Attributes;
+
+namespace HexPi
+{
+
+    /**
+     * @class   KinematicsBenchmarks
+     *
+     * @brief   Measures the hot paths of one tick for all six legs: path of each leg (walk, turn),
+     *          gait (x/y and z of the tcp), pose of the body, balance controller and encoding of the frames.
+     *          The legs are the ones of Hexapod.init() on simulated legcontrollers.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    [MemoryDiagnoser]
+    public class KinematicsBenchmarks
+    {
+        #region Objects
+        /** @brief   The gait and pose of all legs. */
+        BodyKinematics body = null;
+
+        /** @brief   The simulated accelerometer (tilted). */
+        SimulatedImu imu = null;
+
+        /** @brief   The balance controller. */
+        BalanceController balancer = null;
+        #endregion Objects
+
+        #region Arrays
+        /** @brief   The legs. */
+        Leg[] legs = null;
+        #endregion Arrays
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public void setup()
+         *
+         * @brief   Creates the legs and walks half a step, so the legs are spread over the gait
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        [GlobalSetup]
+        public void setup()
+        {
+            SimulatedBackend backend = new SimulatedBackend();
+            body = new BodyKinematics(6);
+            legs = new Leg[6];
+            legs[0] = new Leg(25, 10, -5, 2, 135, backend.open(0x11, 0), 150, 175, body, 0);
+            legs[2] = new Leg(75, 5, -2, 7, 180, backend.open(0x12, 2), 0, 175, body, 2);
+            legs[4] = new Leg(25, 3, -4, 3, 225, backend.open(0x13, 4), -150, 175, body, 4);
+            legs[1] = new Leg(75, 0, -7, 0, 45, backend.open(0x21, 1), 150, -175, body, 1);
+            legs[3] = new Leg(25, 0, 0, -3, 0, backend.open(0x22, 3), 0, -175, body, 3);
+            legs[5] = new Leg(75, -7, 6, 3, 315, backend.open(0x23, 5), -150, -175, body, 5);
+            foreach (Leg l in legs)
+            {
+                l.sendCalibrationData();
+            }
+
+            for (int i = 0; i < BodyKinematics.period / 2; i++)
+            {
+                walk();
+                gait();
+            }
+
+            imu = new SimulatedImu();
+            imu.Pitch = 0.05;
+            imu.Roll = -0.03;
+            balancer = new BalanceController();
+        }
+
+
+
+        /**
+         * @fn  public void walk()
+         *
+         * @brief   Path of each leg while walking (Leg.calcPositionWalk)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        [Benchmark]
+        public void walk()
+        {
+            foreach (Leg l in legs)
+            {
+                l.calcPositionWalk(1, 0, (byte)Controller.modes.DEFAULT);
+            }
+        }
+
+
+
+        /**
+         * @fn  public void turn()
+         *
+         * @brief   Path of each leg while turning (Leg.calcPositionTurn)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        [Benchmark]
+        public void turn()
+        {
+            foreach (Leg l in legs)
+            {
+                l.calcPositionTurn(1, 0.5, (byte)Controller.modes.DEFAULT);
+            }
+        }
+
+
+
+        /**
+         * @fn  public void gait()
+         *
+         * @brief   X/y and z of the tcp of all legs (BodyKinematics.calcGait)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        [Benchmark]
+        public void gait()
+        {
+            body.calcGait(false);
+        }
+
+
+
+        /**
+         * @fn  public void gaitTerrain()
+         *
+         * @brief   X/y and z of the tcp of all legs in terrain mode (BodyKinematics.calcGait)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        [Benchmark]
+        public void gaitTerrain()
+        {
+            body.calcGait(true);
+        }
+
+
+
+        /**
+         * @fn  public void pose()
+         *
+         * @brief   Pose of the body (BodyKinematics.calcPose)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        [Benchmark]
+        public void pose()
+        {
+            body.calcPose(5, 3, -2, 10, -10, 20);
+        }
+
+
+
+        /**
+         * @fn  public double balance()
+         *
+         * @brief   Balance controller with a new reading (BalanceController.update)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The pitch of the body.
+         */
+
+        [Benchmark]
+        public double balance()
+        {
+            imu.read();
+            balancer.update(imu);
+            return balancer.Pitch;
+        }
+
+
+
+        /**
+         * @fn  public void encode()
+         *
+         * @brief   Frames of all legs written to the simulated legcontrollers (Leg.calcData)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        [Benchmark]
+        public void encode()
+        {
+            foreach (Leg l in legs)
+            {
+                l.calcData();
+            }
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,42 @@
+﻿/**********************************************************************************************//**
+ * @file    Program.cs
+ *
+ * @brief   Implements the program class.
+ **************************************************************************************************/
+
+using BenchmarkDotNet.Running;
+
+namespace HexPi
+{
+
+    /**
+     * @class   Program
+     *
+     * @brief   Runs the micro-benchmarks of the kinematics, gait and ticks (BenchmarkDotNet).
+     *          Usage: dotnet run -c Release -- [--filter pattern] (e.g. --filter '*Tick*', all with '*').
+     *          Compare the reports in BenchmarkDotNet.Artifacts between releases (time and allocated bytes per call).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    static class Program
+    {
+
+        /**
+         * @fn  static void Main(string[] args)
+         *
+         * @brief   Main entry-point for this application
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   args    The arguments of BenchmarkDotNet.
+         */
+
+        static void Main(string[] args)
+        {
+            BenchmarkSwitcher.FromAssembly(typeof(Program).Assembly).Run(args);
+        }
+    }
+}
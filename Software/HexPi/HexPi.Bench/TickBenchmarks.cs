@@ -0,0 +1,143 @@
+﻿/**********************************************************************************************//**
+ * @file    TickBenchmarks.cs
+ *
+ * @brief   Implements the tick benchmarks class.
+ **************************************************************************************************/
+
+using BenchmarkDotNet.Attributes;
+
+namespace HexPi
+{
+
+    /**
+     * @class   TickBenchmarks
+     *
+     * @brief   Measures a full tick of the controller (input, all stages, bookkeeping) on simulated legs
+     *          for each direction and mode. The rate is fixed, so every tick does the same work.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    [MemoryDiagnoser]
+    public class TickBenchmarks
+    {
+        #region Objects
+        /** @brief   The controller. */
+        Controller control = null;
+        #endregion Objects
+
+        #region PROPERTIES
+
+        /**
+         * @property    public string Direction
+         *
+         * @brief   Gets or sets the direction (xy, turn, rotate or pose)
+         *
+         * @return  The direction.
+         */
+
+        [Params("xy", "turn", "rotate", "pose")]
+        public string Direction { get; set; }
+
+        /**
+         * @property    public string Mode
+         *
+         * @brief   Gets or sets the mode (default, terrain or balance)
+         *
+         * @return  The mode.
+         */
+
+        [Params("default", "terrain", "balance")]
+        public string Mode { get; set; }
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public void setup()
+         *
+         * @brief   Creates the controller, selects the direction and holds the mode and the sticks
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        [GlobalSetup]
+        public void setup()
+        {
+            SimulatedInput input = new SimulatedInput();
+            SimulatedImu imu = new SimulatedImu();
+            imu.Pitch = 0.05;
+            imu.Roll = -0.03;
+
+            control = new Controller(input, imu, new SimulatedBackend());
+            control.Adaptive = false;
+            control.init();
+
+            InputState state = new InputState();
+            switch (Direction)
+            {
+                case "turn":
+                    state.Buttons = Controller.buttons.DPADRIGHT;
+                    break;
+                case "rotate":
+                    state.Buttons = Controller.buttons.DPADDOWN;
+                    break;
+                case "pose":
+                    state.Buttons = Controller.buttons.DPADLEFT;
+                    break;
+                default:
+                    state.Buttons = Controller.buttons.DPADUP;
+                    break;
+            }
+            input.State = state;
+            control.tick();
+
+            state = new InputState();
+            state.LeftThumbstickX = Direction == "rotate" ? 1 : 0.3;
+            state.LeftThumbstickY = Direction == "rotate" ? 0 : -1;
+            state.RightThumbstickX = 0.5;
+            state.RightThumbstickY = 0.3;
+            switch (Mode)
+            {
+                case "terrain":
+                    state.Buttons = Controller.buttons.LEFTSHOULDER;
+                    break;
+                case "balance":
+                    state.Buttons = Controller.buttons.RIGHTSHOULDER;
+                    break;
+                default:
+                    state.Buttons = Controller.buttons.NONE;
+                    break;
+            }
+            input.State = state;
+
+            //finish the transition to the center
+            for (int i = 0; i < 200; i++)
+            {
+                control.tick();
+            }
+        }
+
+
+
+        /**
+         * @fn  public void tick()
+         *
+         * @brief   One tick of the controller
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        [Benchmark]
+        public void tick()
+        {
+            control.tick();
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,185 @@
+﻿/**********************************************************************************************//**
+ * @file    AdaptiveRate.cs
+ *
+ * @brief   Implements the adaptive rate class.
+ **************************************************************************************************/
+
+using System;
+using System.Diagnostics;
+
+namespace HexPi
+{
+
+    /**
+     * @class   AdaptiveRate
+     *
+     * @brief   Estimates the bus time and the duration of a tick per mode (moving average and deviation)
+     *          and derives the shortest timeframe that keeps the load of the bus below maxLoad.
+     *          With a pipelined bus both overlap, so the longer one limits the rate.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class AdaptiveRate
+    {
+
+        /**
+         * @struct  Estimate
+         *
+         * @brief   The estimate of a mode (times in microseconds).
+         */
+
+        public struct Estimate
+        {
+            /** @brief   The mean bus time of a tick. */
+            public double BusTime;
+            /** @brief   The mean deviation of the bus time. */
+            public double BusDeviation;
+            /** @brief   The mean duration of a tick (bus and calculation). */
+            public double TickTime;
+            /** @brief   The mean deviation of the duration. */
+            public double Deviation;
+            /** @brief   The number of measured ticks. */
+            public long Samples;
+        }
+
+        #region Objects
+        /** @brief   Lock for the estimates. */
+        object estimateLock = new object();
+        #endregion Objects
+
+        #region CONSTANTS
+        /** @brief   The weight of a new measurement. */
+        private const double weight = 0.05;
+
+        /** @brief   The maximum load of the bus (the rest is left for sensing and telemetry). */
+        private const double maxLoad = 0.75;
+
+        /** @brief   The number of deviations added to the mean duration. */
+        private const double margin = 3;
+
+        /** @brief   The number of ticks before an estimate is used. */
+        private const int warmup = 8;
+        #endregion CONSTANTS
+
+        #region Arrays
+        /** @brief   The estimates by mode. */
+        private Estimate[] estimates;
+        #endregion Arrays
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public AdaptiveRate(int modes)
+         *
+         * @brief   Constructor
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   modes   The number of modes.
+         */
+
+        public AdaptiveRate(int modes)
+        {
+            estimates = new Estimate[modes];
+        }
+
+
+
+        /**
+         * @fn  public void record(byte mode, long bus, long duration)
+         *
+         * @brief   Adds a measured tick to the estimate of a mode
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   mode        The mode.
+         * @param   bus         The bus time in stopwatch ticks.
+         * @param   duration    The duration in stopwatch ticks.
+         */
+
+        public void record(byte mode, long bus, long duration)
+        {
+            double us = 1000000.0 / Stopwatch.Frequency;
+            double busTime = bus * us;
+            double tickTime = duration * us;
+
+            lock (estimateLock)
+            {
+                Estimate e = estimates[mode];
+                if (e.Samples == 0)
+                {
+                    e.BusTime = busTime;
+                    e.TickTime = tickTime;
+                    e.BusDeviation = 0;
+                    e.Deviation = 0;
+                }
+                else
+                {
+                    e.BusDeviation += weight * (Math.Abs(busTime - e.BusTime) - e.BusDeviation);
+                    e.Deviation += weight * (Math.Abs(tickTime - e.TickTime) - e.Deviation);
+                    e.BusTime += weight * (busTime - e.BusTime);
+                    e.TickTime += weight * (tickTime - e.TickTime);
+                }
+                e.Samples++;
+                estimates[mode] = e;
+            }
+        }
+
+
+
+        /**
+         * @fn  public long getTimeframe(byte mode, long min, long initial)
+         *
+         * @brief   Gets the shortest sustainable timeframe of a mode
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   mode    The mode.
+         * @param   min     The minimum timeframe in microseconds.
+         * @param   initial The timeframe in microseconds until the mode was measured.
+         *
+         * @return  The timeframe in microseconds.
+         */
+
+        public long getTimeframe(byte mode, long min, long initial)
+        {
+            Estimate e = getEstimate(mode);
+            if (e.Samples < warmup)
+            {
+                return Math.Max(min, initial);
+            }
+            double busy = Math.Max(e.TickTime + margin * e.Deviation, e.BusTime + margin * e.BusDeviation);
+            return Math.Max(min, (long)Math.Ceiling(busy / maxLoad));
+        }
+
+
+
+        /**
+         * @fn  public Estimate getEstimate(byte mode)
+         *
+         * @brief   Gets the estimate of a mode
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   mode    The mode.
+         *
+         * @return  The estimate.
+         */
+
+        public Estimate getEstimate(byte mode)
+        {
+            lock (estimateLock)
+            {
+                return estimates[mode];
+            }
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,226 @@
+﻿/**********************************************************************************************//**
+ * @file    BalanceController.cs
+ *
+ * @brief   Implements the balance controller class.
+ **************************************************************************************************/
+
+using System.Diagnostics;
+
+namespace HexPi
+{
+
+    /**
+     * @class   BalanceController
+     *
+     * @brief   PID-controller that keeps the body level (pitch and roll).
+     *          Each new reading of the inertial sensor is one step, the time step is the time between the
+     *          readings, so the gains do not depend on the rate of the gait. A tick without a new reading keeps
+     *          the last output. The derivative uses the rate of the gyroscope, the integral stops while the output
+     *          is at its limit (anti-windup).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class BalanceController
+    {
+
+        /**
+         * @class   Axis
+         *
+         * @brief   The controller of one angle.
+         */
+
+        private class Axis
+        {
+            /** @brief   The integral of the angle in rad*s. */
+            public double Integral;
+            /** @brief   The output in rad. */
+            public double Output;
+
+            public void update(BalanceController c, double angle, double rate, double dt)
+            {
+                double integral = Integral + angle * dt;
+                double output = c.Kp * angle + c.Ki * integral + c.Kd * rate;
+
+                //anti-windup: keep the integral only while it does not push the output further over the limit
+                if (output > c.Limit)
+                {
+                    output = c.Limit;
+                    if (angle < 0)
+                    {
+                        Integral = integral;
+                    }
+                }
+                else if (output < -c.Limit)
+                {
+                    output = -c.Limit;
+                    if (angle > 0)
+                    {
+                        Integral = integral;
+                    }
+                }
+                else
+                {
+                    Integral = integral;
+                }
+                Output = output;
+            }
+        }
+
+        #region Objects
+        /** @brief   The pitch controller. */
+        Axis pitch = new Axis();
+
+        /** @brief   The roll controller. */
+        Axis roll = new Axis();
+        #endregion Objects
+
+        #region FIELDS
+        /** @brief   The timestamp of the last reading (0 = none). */
+        private long lastTimestamp = 0;
+        #endregion FIELDS
+
+        #region CONSTANTS
+        /** @brief   The maximum time step in seconds (longer gaps, e.g. after a reset, are not integrated). */
+        private const double maxStep = 0.1;
+        #endregion CONSTANTS
+
+        #region PROPERTIES
+
+        /**
+         * @property    public double Kp
+         *
+         * @brief   Gets or sets the p constant
+         *
+         * @return  The p constant.
+         */
+
+        public double Kp { get; set; } = 0.01;
+
+        /**
+         * @property    public double Ki
+         *
+         * @brief   Gets or sets the i constant (per second)
+         *
+         * @return  The i constant.
+         */
+
+        public double Ki { get; set; } = 1;
+
+        /**
+         * @property    public double Kd
+         *
+         * @brief   Gets or sets the d constant (seconds)
+         *
+         * @return  The d constant.
+         */
+
+        public double Kd { get; set; } = 0;
+
+        /**
+         * @property    public double Limit
+         *
+         * @brief   Gets or sets the maximum pitch and roll of the output
+         *
+         * @return  The limit in rad.
+         */
+
+        public double Limit { get; set; } = 10 * 0.0174533;
+
+        /**
+         * @property    public double Pitch
+         *
+         * @brief   Gets the pitch of the body
+         *
+         * @return  The pitch in rad.
+         */
+
+        public double Pitch
+        {
+            get { return pitch.Output; }
+        }
+
+        /**
+         * @property    public double Roll
+         *
+         * @brief   Gets the roll of the body
+         *
+         * @return  The roll in rad.
+         */
+
+        public double Roll
+        {
+            get { return roll.Output; }
+        }
+
+        /**
+         * @property    public double Step
+         *
+         * @brief   Gets the time step of the last update
+         *
+         * @return  The time step in seconds (0 if the last tick had no new reading).
+         */
+
+        public double Step { get; private set; }
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public void update(IImu imu)
+         *
+         * @brief   Updates the output with the last reading of the inertial sensor (read() is called by the caller)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   imu The inertial sensor.
+         */
+
+        public void update(IImu imu)
+        {
+            long timestamp = imu.Timestamp;
+            if (timestamp == lastTimestamp && timestamp != 0)
+            {
+                Step = 0;
+                return;
+            }
+
+            double dt = lastTimestamp == 0 ? 0 : (double)(timestamp - lastTimestamp) / Stopwatch.Frequency;
+            if (dt < 0 || dt > maxStep)
+            {
+                dt = 0;
+            }
+            lastTimestamp = timestamp;
+            Step = dt;
+
+            pitch.update(this, imu.Pitch, imu.PitchRate, dt);
+            roll.update(this, imu.Roll, imu.RollRate, dt);
+        }
+
+
+
+        /**
+         * @fn  public void reset()
+         *
+         * @brief   Levels the body and clears the integrals
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void reset()
+        {
+            pitch.Integral = 0;
+            pitch.Output = 0;
+            roll.Integral = 0;
+            roll.Output = 0;
+            lastTimestamp = 0;
+            Step = 0;
+        }
+
+        #endregion FUNCTIONS
+    }
+}
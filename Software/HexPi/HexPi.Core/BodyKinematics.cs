@@ -0,0 +1,361 @@
+﻿/**********************************************************************************************//**
+ * @file    BodyKinematics.cs
+ *
+ * @brief   Implements the body kinematics class.
+ **************************************************************************************************/
+
+using System;
+using System.Numerics;
+
+namespace HexPi
+{
+
+    /**
+     * @class   BodyKinematics
+     *
+     * @brief   The gait and pose of all legs. The state of the legs is held in arrays (one element per leg,
+     *          padded to a multiple of the vector size), the tcp positions of all legs are calculated together
+     *          with System.Numerics.Vector and the rotation matrix of the body once per call.
+     *          The legs keep their control logic (direction changes, step size) and write the path here.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class BodyKinematics
+    {
+
+        /**
+         * @struct  Segment
+         *
+         * @brief   A segment of the path of a gait, valid for t up to End:
+         *          k = K + KSlope * (t - KStart) (factor of the step size) and z = Z + ZCurve * (t - ZTop)^2.
+         */
+
+        private struct Segment
+        {
+            /** @brief   The end of the segment (control variable). */
+            public Vector<double> End;
+            /** @brief   The factor of the step size at KStart. */
+            public Vector<double> K;
+            /** @brief   The slope of the factor. */
+            public Vector<double> KSlope;
+            /** @brief   The start of the slope. */
+            public Vector<double> KStart;
+            /** @brief   The height at ZTop. */
+            public Vector<double> Z;
+            /** @brief   The curvature of the height. */
+            public Vector<double> ZCurve;
+            /** @brief   The top of the height. */
+            public Vector<double> ZTop;
+
+            public Segment(double end, double k, double kSlope, double kStart, double z, double zCurve, double zTop)
+            {
+                End = new Vector<double>(end);
+                K = new Vector<double>(k);
+                KSlope = new Vector<double>(kSlope);
+                KStart = new Vector<double>(kStart);
+                Z = new Vector<double>(z);
+                ZCurve = new Vector<double>(zCurve);
+                ZTop = new Vector<double>(zTop);
+            }
+        }
+
+        #region CONSTANTS
+
+        /** @brief   The step size for z coordinate in mm. */
+        public const double stepSizeZ = 40;
+
+        /** @brief   The step size for xy coordinates in mm. */
+        public const double stepSizeXY = 30;
+
+        /** @brief   The period. */
+        public const int period = 100;
+
+        /** @brief   The section to lift the leg in terrain mode */
+        public const int lift = period / 2 + 10;
+
+        /** @brief   The section to sense the ground in terrain mode */
+        public const int sense = period / 2 + 40;
+
+        /** @brief   The height of the first joint. */
+        public const double zOffset = 88;
+
+        #endregion CONSTANTS
+
+        #region Arrays
+
+        /**
+         * @brief   The gait in default mode: stance 0 - period/2 (ground), swing period/2 - period
+         *          (parabola, top at 0.6*period).
+         */
+        private static readonly Segment[] defaultGait =
+        {
+            new Segment(period / 2, 1, -4.0 / period, 0, 0, 0, 0),
+            new Segment(0.6 * period, -3, 4.0 / period, 0, stepSizeZ, -(stepSizeZ * 100 / (period * period)), 0.6 * period),
+            new Segment(period, -3, 4.0 / period, 0, stepSizeZ, -(stepSizeZ * 6.25 / (period * period)), 0.6 * period)
+        };
+
+        /**
+         * @brief   The gait in terrain mode: stance 0 - period/2, lift period/2 - lift, swing lift - sense,
+         *          sense - period (ground).
+         */
+        private static readonly Segment[] terrainGait =
+        {
+            new Segment(period / 2, 1, -4.0 / period, 0, 0, 0, 0),
+            new Segment(lift, -1, 0, 0, stepSizeZ, 0, 0),
+            new Segment(sense, -1, 2.0 / (sense - lift), lift, stepSizeZ, 0, 0),
+            new Segment(period, 1, 0, 0, 0, 0, 0)
+        };
+
+        #endregion Arrays
+
+        #region PROPERTIES
+
+        /**
+         * @property    public int Count
+         *
+         * @brief   Gets the number of legs
+         *
+         * @return  The number of legs.
+         */
+
+        public int Count { get; }
+
+        /**
+         * @property    public double[] T
+         *
+         * @brief   Gets the control variables (0 - period)
+         *
+         * @return  The control variable of each leg.
+         */
+
+        public double[] T { get; }
+
+        /**
+         * @property    public double[] X
+         *
+         * @brief   Gets the x positions of the tcps
+         *
+         * @return  The x position of each leg.
+         */
+
+        public double[] X { get; }
+
+        /**
+         * @property    public double[] Y
+         *
+         * @brief   Gets the y positions of the tcps
+         *
+         * @return  The y position of each leg.
+         */
+
+        public double[] Y { get; }
+
+        /**
+         * @property    public double[] Z
+         *
+         * @brief   Gets the z positions of the tcps
+         *
+         * @return  The z position of each leg.
+         */
+
+        public double[] Z { get; }
+
+        /**
+         * @property    public double[] XOffset
+         *
+         * @brief   Gets the x offsets of the legs from the center of the body
+         *
+         * @return  The x offset of each leg.
+         */
+
+        public double[] XOffset { get; }
+
+        /**
+         * @property    public double[] YOffset
+         *
+         * @brief   Gets the y offsets of the legs from the center of the body
+         *
+         * @return  The y offset of each leg.
+         */
+
+        public double[] YOffset { get; }
+
+        /**
+         * @property    public double[] Step
+         *
+         * @brief   Gets the step sizes of the paths
+         *
+         * @return  The step size of each leg.
+         */
+
+        public double[] Step { get; }
+
+        /**
+         * @property    public double[] Cos
+         *
+         * @brief   Gets the cosine of the path angles
+         *
+         * @return  The cosine of the path angle of each leg.
+         */
+
+        public double[] Cos { get; }
+
+        /**
+         * @property    public double[] Sin
+         *
+         * @brief   Gets the sine of the path angles
+         *
+         * @return  The sine of the path angle of each leg.
+         */
+
+        public double[] Sin { get; }
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public BodyKinematics(int count)
+         *
+         * @brief   Constructor
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   count   The number of legs.
+         */
+
+        public BodyKinematics(int count)
+        {
+            int n = Vector<double>.Count;
+            int size = (count + n - 1) / n * n;
+
+            Count = count;
+            T = new double[size];
+            X = new double[size];
+            Y = new double[size];
+            Z = new double[size];
+            XOffset = new double[size];
+            YOffset = new double[size];
+            Step = new double[size];
+            Cos = new double[size];
+            Sin = new double[size];
+        }
+
+
+
+        /**
+         * @fn  public void calcGait(bool terrain)
+         *
+         * @brief   Calculates the tcp positions of all legs from their control variable and path
+         *          (segments of the gait table of the mode).
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   terrain True in terrain mode.
+         */
+
+        public void calcGait(bool terrain)
+        {
+            Segment[] gait = terrain ? terrainGait : defaultGait;
+            Segment last = gait[gait.Length - 1];
+            Vector<double> stepZ = new Vector<double>(stepSizeZ);
+            Vector<double> maxXY = new Vector<double>(stepSizeXY);
+            Vector<double> minXY = new Vector<double>(-stepSizeXY);
+            Vector<double> minZ = new Vector<double>(-stepSizeZ);
+
+            for (int i = 0; i < T.Length; i += Vector<double>.Count)
+            {
+                Vector<double> t = new Vector<double>(T, i);
+                //factor of the path: 1 (front) to -1 (back) and height, starting with the last segment
+                Vector<double> k = last.K + last.KSlope * (t - last.KStart);
+                Vector<double> dz = t - last.ZTop;
+                Vector<double> z = last.Z + last.ZCurve * dz * dz;
+
+                for (int s = gait.Length - 2; s >= 0; s--)
+                {
+                    Segment segment = gait[s];
+                    Vector<long> inside = Vector.LessThanOrEqual(t, segment.End);
+                    dz = t - segment.ZTop;
+                    k = Vector.ConditionalSelect(inside, segment.K + segment.KSlope * (t - segment.KStart), k);
+                    z = Vector.ConditionalSelect(inside, segment.Z + segment.ZCurve * dz * dz, z);
+                }
+
+                Vector<double> p = k * new Vector<double>(Step, i);
+                Vector.Min(maxXY, Vector.Max(minXY, p * new Vector<double>(Cos, i))).CopyTo(X, i);
+                Vector.Min(maxXY, Vector.Max(minXY, p * new Vector<double>(Sin, i))).CopyTo(Y, i);
+                Vector.Min(stepZ, Vector.Max(minZ, z)).CopyTo(Z, i);
+            }
+        }
+
+
+
+        /**
+         * @fn  public void calcPose(double yaw, double pitch, double roll, double a, double b, double c)
+         *
+         * @brief   Rotates the body around its center and moves it (all legs, one rotation matrix)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   yaw     The yaw.
+         * @param   pitch   The pitch.
+         * @param   roll    The roll.
+         * @param   a       Distance to move along the x axis.
+         * @param   b       Distance to move along the y axis.
+         * @param   c       Distance to move along the z axis.
+         */
+
+        public void calcPose(double yaw, double pitch, double roll, double a, double b, double c)
+        {
+            double sA = Math.Sin(yaw);
+            double sB = Math.Sin(pitch);
+            double sC = Math.Sin(roll);
+            double cA = Math.Cos(yaw);
+            double cB = Math.Cos(pitch);
+            double cC = Math.Cos(roll);
+
+            //Roll-Pitch-Yaw-Rotation matrix
+            Vector<double> m00 = new Vector<double>(cA * cB);
+            Vector<double> m01 = new Vector<double>(cA * sB * sC - sA * cC);
+            Vector<double> m02 = new Vector<double>(sA * sC + cA * sB * cC);
+            Vector<double> m10 = new Vector<double>(sA * cB);
+            Vector<double> m11 = new Vector<double>(cA * cC + sA * sB * sC);
+            Vector<double> m12 = new Vector<double>(sA * sB * cC - cA * sC);
+            Vector<double> m20 = new Vector<double>(-sB);
+            Vector<double> m21 = new Vector<double>(cB * sC);
+            Vector<double> m22 = new Vector<double>(cB * cC);
+
+            Vector<double> va = new Vector<double>(a);
+            Vector<double> vb = new Vector<double>(b);
+            Vector<double> vc = new Vector<double>(c);
+            Vector<double> height = new Vector<double>(zOffset);
+
+            for (int i = 0; i < T.Length; i += Vector<double>.Count)
+            {
+                Vector<double> x = new Vector<double>(X, i);
+                Vector<double> y = new Vector<double>(Y, i);
+                Vector<double> z = new Vector<double>(Z, i);
+
+                //TCP coordinate in global coordinate system ( 0/0/0 = center of body ; +x = front; +z = top ; +y = left)
+                Vector<double> tempX = new Vector<double>(XOffset, i) - x;
+                Vector<double> tempY = new Vector<double>(YOffset, i) - y;
+                Vector<double> tempZ = height - z;
+
+                Vector<double> newX = tempX * m00 + tempY * m01 + tempZ * m02;
+                Vector<double> newY = tempX * m10 + tempY * m11 + tempZ * m12;
+                Vector<double> newZ = tempX * m20 + tempY * m21 + tempZ * m22;
+
+                //Set leg position in local coordinate system
+                (x + newX - tempX + va).CopyTo(X, i);
+                (y + newY - tempY + vb).CopyTo(Y, i);
+                (z + newZ - tempZ + vc).CopyTo(Z, i);
+            }
+        }
+
+        #endregion FUNCTIONS
+    }
+}
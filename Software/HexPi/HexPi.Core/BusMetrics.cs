@@ -0,0 +1,602 @@
+﻿/**********************************************************************************************//**
+ * @file    BusMetrics.cs
+ *
+ * @brief   Implements the bus metrics class.
+ **************************************************************************************************/
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+
+namespace HexPi
+{
+
+    /**
+     * @class   BusMetrics
+     *
+     * @brief   Counts the transfers of each leg: duration of writes and reads, NACKs (the legcontroller did not
+     *          acknowledge), exceptions of the driver and retries (a transfer right after a failed one), and the
+     *          load of the bus per tick. Wraps the actuators next to the driver, so the bus thread is measured
+     *          as well. Exceptions are caught, logged and counted here, the leg sees a failed transfer.
+     *          The counters are logged once a minute and written in the Prometheus text format.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class BusMetrics
+    {
+
+        /**
+         * @struct  LegStatistics
+         *
+         * @brief   The transfers of a leg since the last reset (times in microseconds).
+         */
+
+        public struct LegStatistics
+        {
+            /** @brief   The number of writes. */
+            public long Writes;
+            /** @brief   The number of reads. */
+            public long Reads;
+            /** @brief   The number of transfers without acknowledge. */
+            public long Nacks;
+            /** @brief   The number of exceptions of the driver. */
+            public long Exceptions;
+            /** @brief   The number of transfers right after a failed one. */
+            public long Retries;
+            /** @brief   The duration of the writes. */
+            public LatencyHistogram.Summary WriteTime;
+            /** @brief   The duration of the reads. */
+            public LatencyHistogram.Summary ReadTime;
+        }
+
+        /**
+         * @struct  Utilization
+         *
+         * @brief   The time on the bus relative to the period of the ticks (0 - 1).
+         */
+
+        public struct Utilization
+        {
+            /** @brief   The number of ticks. */
+            public long Ticks;
+            /** @brief   The load of the last tick. */
+            public double Last;
+            /** @brief   The mean load. */
+            public double Mean;
+            /** @brief   The maximum load. */
+            public double Max;
+        }
+
+        /**
+         * @class   Counters
+         *
+         * @brief   The counters of a leg (locked by the metrics).
+         */
+
+        private class Counters
+        {
+            public long Writes;
+            public long Reads;
+            public long Nacks;
+            public long Exceptions;
+            public long Retries;
+            /** @brief   True if the last transfer failed. */
+            public bool Failed;
+            public LatencyHistogram WriteTime = new LatencyHistogram();
+            public LatencyHistogram ReadTime = new LatencyHistogram();
+        }
+
+        /**
+         * @class   Bus
+         *
+         * @brief   Measures the bus of a leg.
+         */
+
+        private class Bus : ILegBus
+        {
+            /** @brief   The metrics. */
+            BusMetrics metrics;
+            /** @brief   The measured bus. */
+            ILegBus inner;
+            /** @brief   The counters of the leg. */
+            Counters counters;
+            /** @brief   The index of the leg. */
+            int index;
+
+            public Bus(BusMetrics metrics, ILegBus inner, Counters counters, int index)
+            {
+                this.metrics = metrics;
+                this.inner = inner;
+                this.counters = counters;
+                this.index = index;
+            }
+
+            public bool write(byte[] data)
+            {
+                long start = Stopwatch.GetTimestamp();
+                bool ok = false;
+                bool thrown = false;
+                try
+                {
+                    ok = inner.write(data);
+                }
+                catch (Exception e)
+                {
+                    thrown = true;
+                    Debug.WriteLine("Error: Leg {0}: write failed! {1}", index, e.Message);
+                }
+                metrics.add(counters, counters.WriteTime, start, ok, thrown);
+                return ok;
+            }
+
+            public bool read(byte[] data)
+            {
+                long start = Stopwatch.GetTimestamp();
+                bool ok = false;
+                bool thrown = false;
+                try
+                {
+                    ok = inner.read(data);
+                }
+                catch (Exception e)
+                {
+                    thrown = true;
+                    Debug.WriteLine("Error: Leg {0}: read failed! {1}", index, e.Message);
+                }
+                metrics.add(counters, counters.ReadTime, start, ok, thrown);
+                return ok;
+            }
+        }
+
+        /**
+         * @class   Backend
+         *
+         * @brief   Measures the actuators.
+         */
+
+        private class Backend : IActuatorBackend
+        {
+            /** @brief   The metrics. */
+            BusMetrics metrics;
+            /** @brief   The measured backend. */
+            IActuatorBackend inner;
+
+            public Backend(BusMetrics metrics, IActuatorBackend inner)
+            {
+                this.metrics = metrics;
+                this.inner = inner;
+            }
+
+            public bool Calibrated => inner.Calibrated;
+
+            public long FramePeriod => inner.FramePeriod;
+
+            public ILegBus open(byte address, int index)
+            {
+                return new Bus(metrics, inner.open(address, index), metrics.getCounters(index), index);
+            }
+
+            public void flush()
+            {
+                inner.flush();
+            }
+        }
+
+        #region Objects
+        /** @brief   Lock for the counters. */
+        object statLock = new object();
+
+        /** @brief   The counters of each leg (index of the leg). */
+        List<Counters> legs = new List<Counters>();
+        #endregion Objects
+
+        #region FIELDS
+        /** @brief   The number of ticks. */
+        private long ticks = 0;
+
+        /** @brief   The load of the last tick. */
+        private double lastLoad = 0;
+
+        /** @brief   The sum of the loads. */
+        private double sumLoad = 0;
+
+        /** @brief   The maximum load. */
+        private double maxLoad = 0;
+
+        /** @brief   The time of the last log (stopwatch ticks). */
+        private long logTime = Stopwatch.GetTimestamp();
+        #endregion FIELDS
+
+        #region CONSTANTS
+        /** @brief   The time between two logs in seconds. */
+        private const int interval = 60;
+        #endregion CONSTANTS
+
+        #region PROPERTIES
+
+        /**
+         * @property    public int Count
+         *
+         * @brief   Gets the number of measured legs
+         *
+         * @return  The number of legs.
+         */
+
+        public int Count
+        {
+            get
+            {
+                lock (statLock)
+                {
+                    return legs.Count;
+                }
+            }
+        }
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public IActuatorBackend wrap(IActuatorBackend backend)
+         *
+         * @brief   Measures the actuators (wrap the driver, not the bus thread)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   backend The actuators.
+         *
+         * @return  The measured actuators.
+         */
+
+        public IActuatorBackend wrap(IActuatorBackend backend)
+        {
+            return new Backend(this, backend);
+        }
+
+
+
+        /**
+         * @fn  public void recordTick(long busTime, long period)
+         *
+         * @brief   Adds the bus time of a tick
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   busTime The bus time of the tick in stopwatch ticks.
+         * @param   period  The period of the tick in microseconds.
+         */
+
+        public void recordTick(long busTime, long period)
+        {
+            if (period <= 0)
+            {
+                return;
+            }
+
+            double load = busTime * 1000000.0 / Stopwatch.Frequency / period;
+            lock (statLock)
+            {
+                ticks++;
+                lastLoad = load;
+                sumLoad += load;
+                if (load > maxLoad)
+                {
+                    maxLoad = load;
+                }
+            }
+        }
+
+
+
+        /**
+         * @fn  public LegStatistics getLeg(int index)
+         *
+         * @brief   Gets the transfers of a leg since the last reset
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   index   The index of the leg.
+         *
+         * @return  The statistics (empty for a leg that was not opened).
+         */
+
+        public LegStatistics getLeg(int index)
+        {
+            LegStatistics s = new LegStatistics();
+            lock (statLock)
+            {
+                if (index < 0 || index >= legs.Count || legs[index] == null)
+                {
+                    return s;
+                }
+
+                Counters c = legs[index];
+                s.Writes = c.Writes;
+                s.Reads = c.Reads;
+                s.Nacks = c.Nacks;
+                s.Exceptions = c.Exceptions;
+                s.Retries = c.Retries;
+                s.WriteTime = c.WriteTime.getSummary();
+                s.ReadTime = c.ReadTime.getSummary();
+            }
+            return s;
+        }
+
+
+
+        /**
+         * @fn  public Utilization getUtilization()
+         *
+         * @brief   Gets the load of the bus since the last reset
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The utilization.
+         */
+
+        public Utilization getUtilization()
+        {
+            Utilization u = new Utilization();
+            lock (statLock)
+            {
+                u.Ticks = ticks;
+                u.Last = lastLoad;
+                u.Max = maxLoad;
+                if (ticks > 0)
+                {
+                    u.Mean = sumLoad / ticks;
+                }
+            }
+            return u;
+        }
+
+
+
+        /**
+         * @fn  public void resetStatistics()
+         *
+         * @brief   Resets the statistics
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void resetStatistics()
+        {
+            lock (statLock)
+            {
+                foreach (Counters c in legs)
+                {
+                    if (c != null)
+                    {
+                        c.Writes = 0;
+                        c.Reads = 0;
+                        c.Nacks = 0;
+                        c.Exceptions = 0;
+                        c.Retries = 0;
+                        c.WriteTime.reset();
+                        c.ReadTime.reset();
+                    }
+                }
+                ticks = 0;
+                lastLoad = 0;
+                sumLoad = 0;
+                maxLoad = 0;
+            }
+        }
+
+
+
+        /**
+         * @fn  public void update()
+         *
+         * @brief   Logs the counters of each leg once a minute (called once per tick)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void update()
+        {
+            long now = Stopwatch.GetTimestamp();
+            if (now - logTime < interval * Stopwatch.Frequency)
+            {
+                return;
+            }
+            logTime = now;
+
+            Utilization u = getUtilization();
+            Debug.WriteLine("Info: Bus load: mean {0:F0}%  max {1:F0}%", 100 * u.Mean, 100 * u.Max);
+            for (int i = 0; i < Count; i++)
+            {
+                LegStatistics s = getLeg(i);
+                Debug.WriteLine("Info: Leg {0}: writes {1} (p99 {2:F0}us)  reads {3} (p99 {4:F0}us)  nacks {5}  exceptions {6}  retries {7}",
+                    i, s.Writes, s.WriteTime.P99, s.Reads, s.ReadTime.P99, s.Nacks, s.Exceptions, s.Retries);
+            }
+        }
+
+
+
+        /**
+         * @fn  public void write(TextWriter writer)
+         *
+         * @brief   Writes the counters in the Prometheus text format
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   writer  The writer.
+         */
+
+        public void write(TextWriter writer)
+        {
+            int count = Count;
+            LegStatistics[] s = new LegStatistics[count];
+            for (int i = 0; i < count; i++)
+            {
+                s[i] = getLeg(i);
+            }
+
+            writeCounter(writer, "hexpi_leg_writes_total", "Frames written to the legcontroller.", s, x => x.Writes);
+            writeCounter(writer, "hexpi_leg_reads_total", "Reads from the legcontroller.", s, x => x.Reads);
+            writeCounter(writer, "hexpi_leg_nacks_total", "Transfers the legcontroller did not acknowledge.", s, x => x.Nacks);
+            writeCounter(writer, "hexpi_leg_exceptions_total", "Transfers that failed with an exception of the driver.", s, x => x.Exceptions);
+            writeCounter(writer, "hexpi_leg_retries_total", "Transfers right after a failed transfer.", s, x => x.Retries);
+            writeQuantiles(writer, "hexpi_leg_write_microseconds", "Duration of a write.", s, x => x.WriteTime);
+            writeQuantiles(writer, "hexpi_leg_read_microseconds", "Duration of a read.", s, x => x.ReadTime);
+
+            Utilization u = getUtilization();
+            writer.Write("# HELP hexpi_bus_utilization Time on the bus relative to the period of a tick.\n");
+            writer.Write("# TYPE hexpi_bus_utilization gauge\n");
+            writer.Write(string.Format(System.Globalization.CultureInfo.InvariantCulture,
+                "hexpi_bus_utilization{{stat=\"last\"}} {0}\nhexpi_bus_utilization{{stat=\"mean\"}} {1}\nhexpi_bus_utilization{{stat=\"max\"}} {2}\n",
+                u.Last, u.Mean, u.Max));
+        }
+
+
+
+        /**
+         * @fn  private void add(Counters c, LatencyHistogram time, long start, bool ok, bool thrown)
+         *
+         * @brief   Adds a transfer
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   c       The counters of the leg.
+         * @param   time    The histogram of the transfer (write or read).
+         * @param   start   The timestamp of the start of the transfer.
+         * @param   ok      True if the transfer succeeded.
+         * @param   thrown  True if the driver threw an exception.
+         */
+
+        private void add(Counters c, LatencyHistogram time, long start, bool ok, bool thrown)
+        {
+            long us = (Stopwatch.GetTimestamp() - start) * 1000000 / Stopwatch.Frequency;
+            lock (statLock)
+            {
+                if (time == c.WriteTime)
+                {
+                    c.Writes++;
+                }
+                else
+                {
+                    c.Reads++;
+                }
+                time.add(us);
+
+                if (c.Failed)
+                {
+                    c.Retries++;
+                }
+                if (thrown)
+                {
+                    c.Exceptions++;
+                }
+                else if (!ok)
+                {
+                    c.Nacks++;
+                }
+                c.Failed = !ok;
+            }
+        }
+
+
+
+        /**
+         * @fn  private Counters getCounters(int index)
+         *
+         * @brief   Gets the counters of a leg (created when the leg is opened)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   index   The index of the leg.
+         *
+         * @return  The counters.
+         */
+
+        private Counters getCounters(int index)
+        {
+            lock (statLock)
+            {
+                while (legs.Count <= index)
+                {
+                    legs.Add(null);
+                }
+                if (legs[index] == null)
+                {
+                    legs[index] = new Counters();
+                }
+                return legs[index];
+            }
+        }
+
+
+
+        /**
+         * @fn  private static void writeCounter(TextWriter writer, string name, string help, LegStatistics[] legs, Func<LegStatistics, long> value)
+         *
+         * @brief   Writes a counter of each leg
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   writer  The writer.
+         * @param   name    The name of the metric.
+         * @param   help    The description.
+         * @param   legs    The statistics of the legs.
+         * @param   value   The counter.
+         */
+
+        private static void writeCounter(TextWriter writer, string name, string help, LegStatistics[] legs, Func<LegStatistics, long> value)
+        {
+            writer.Write("# HELP " + name + " " + help + "\n");
+            writer.Write("# TYPE " + name + " counter\n");
+            for (int i = 0; i < legs.Length; i++)
+            {
+                writer.Write(name + "{leg=\"" + i + "\"} " + value(legs[i]) + "\n");
+            }
+        }
+
+
+
+        /**
+         * @fn  private static void writeQuantiles(TextWriter writer, string name, string help, LegStatistics[] legs, Func<LegStatistics, LatencyHistogram.Summary> value)
+         *
+         * @brief   Writes the percentiles of a duration of each leg (p50, p99, max)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   writer  The writer.
+         * @param   name    The name of the metric.
+         * @param   help    The description.
+         * @param   legs    The statistics of the legs.
+         * @param   value   The duration.
+         */
+
+        private static void writeQuantiles(TextWriter writer, string name, string help, LegStatistics[] legs, Func<LegStatistics, LatencyHistogram.Summary> value)
+        {
+            writer.Write("# HELP " + name + " " + help + "\n");
+            writer.Write("# TYPE " + name + " gauge\n");
+            for (int i = 0; i < legs.Length; i++)
+            {
+                LatencyHistogram.Summary s = value(legs[i]);
+                writer.Write(string.Format(System.Globalization.CultureInfo.InvariantCulture,
+                    "{0}{{leg=\"{1}\",quantile=\"0.5\"}} {2}\n{0}{{leg=\"{1}\",quantile=\"0.99\"}} {3}\n{0}{{leg=\"{1}\",quantile=\"1\"}} {4}\n",
+                    name, i, s.P50, s.P99, s.Max));
+            }
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,183 @@
+﻿/**********************************************************************************************//**
+ * @file    BusTimer.cs
+ *
+ * @brief   Implements the bus timer class.
+ **************************************************************************************************/
+
+using System.Diagnostics;
+using System.Threading;
+
+namespace HexPi
+{
+
+    /**
+     * @class   BusTimer
+     *
+     * @brief   Measures the time spent on the bus. Wraps the actuators, every write, read and flush adds its
+     *          duration. The accelerometer is read by its own sampler, its bus time is taken with the time of the legs.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class BusTimer
+    {
+
+        /**
+         * @class   Bus
+         *
+         * @brief   Measures the bus of a leg.
+         */
+
+        private class Bus : ILegBus
+        {
+            /** @brief   The timer. */
+            BusTimer timer;
+            /** @brief   The measured bus. */
+            ILegBus inner;
+
+            public Bus(BusTimer timer, ILegBus inner)
+            {
+                this.timer = timer;
+                this.inner = inner;
+            }
+
+            public bool write(byte[] data)
+            {
+                long start = Stopwatch.GetTimestamp();
+                bool ok = inner.write(data);
+                timer.add(start);
+                return ok;
+            }
+
+            public bool read(byte[] data)
+            {
+                long start = Stopwatch.GetTimestamp();
+                bool ok = inner.read(data);
+                timer.add(start);
+                return ok;
+            }
+        }
+
+        /**
+         * @class   Backend
+         *
+         * @brief   Measures the actuators.
+         */
+
+        private class Backend : IActuatorBackend
+        {
+            /** @brief   The timer. */
+            BusTimer timer;
+            /** @brief   The measured backend. */
+            IActuatorBackend inner;
+
+            public Backend(BusTimer timer, IActuatorBackend inner)
+            {
+                this.timer = timer;
+                this.inner = inner;
+            }
+
+            public bool Calibrated => inner.Calibrated;
+
+            public long FramePeriod => inner.FramePeriod;
+
+            public ILegBus open(byte address, int index)
+            {
+                return new Bus(timer, inner.open(address, index));
+            }
+
+            public void flush()
+            {
+                long start = Stopwatch.GetTimestamp();
+                inner.flush();
+                timer.add(start);
+            }
+        }
+
+        #region Objects
+        /** @brief   The measured accelerometer (null if none). */
+        IImu imu = null;
+        #endregion Objects
+
+        #region FIELDS
+        /** @brief   The bus time since the last take() in stopwatch ticks. */
+        private long elapsed = 0;
+        #endregion FIELDS
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public IActuatorBackend wrap(IActuatorBackend backend)
+         *
+         * @brief   Measures the actuators
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   backend The actuators.
+         *
+         * @return  The measured actuators.
+         */
+
+        public IActuatorBackend wrap(IActuatorBackend backend)
+        {
+            return new Backend(this, backend);
+        }
+
+        /**
+         * @fn  public IImu wrap(IImu imu)
+         *
+         * @brief   Measures the accelerometer (its reads since the last take() are added there)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   imu The accelerometer.
+         *
+         * @return  The accelerometer.
+         */
+
+        public IImu wrap(IImu imu)
+        {
+            this.imu = imu;
+            return imu;
+        }
+
+        /**
+         * @fn  public long take()
+         *
+         * @brief   Gets the bus time of the legs and the accelerometer since the last call and starts the next
+         *          measurement
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The bus time in stopwatch ticks.
+         */
+
+        public long take()
+        {
+            long sensor = imu != null ? imu.takeBusTime() : 0;
+            return Interlocked.Exchange(ref elapsed, 0) + sensor;
+        }
+
+        /**
+         * @fn  private void add(long start)
+         *
+         * @brief   Adds the time since start to the bus time
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   start   The timestamp of the start of the transfer.
+         */
+
+        private void add(long start)
+        {
+            Interlocked.Add(ref elapsed, Stopwatch.GetTimestamp() - start);
+        }
+
+        #endregion FUNCTIONS
+    }
+}
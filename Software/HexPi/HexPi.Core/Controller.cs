@@ -0,0 +1,917 @@
+﻿/**
+ * @file    controller.cs.
+ *
+ * @brief   Implements the controller class
+ */
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using System.Threading;
+
+namespace HexPi
+{
+
+
+    /**
+     * @class   Controller
+     *
+     * @brief   A controller.
+     *
+     * @author  Alexander Miller
+     * @date    13.08.2017
+     */
+
+    class Controller
+    {
+        #region Objects
+        /** @brief   The input device (XBox360 Wireless Gamepad or a simulation). */
+        IInputSource input = null;
+
+        /** @brief   The accelerometer (or a simulation). */
+        IImu accel = null;
+
+        /** @brief   The actuators (legcontrollers, servo hat or simulation). */
+        IActuatorBackend backend = null;
+
+        /** @brief   The robot. */
+        Hexapod robot = new Hexapod();
+
+        /** @brief   The input task. */
+        Task inputTask = null;
+
+        /** @brief   The scheduler of the input task. */
+        TickScheduler scheduler = new TickScheduler(timeframe);
+
+        /** @brief   Measures the time spent on the bus. */
+        BusTimer busTimer = new BusTimer();
+
+        /** @brief   The bus thread (null if the control thread sends the frames itself). */
+        PipelinedBackend pipeline = null;
+
+        /** @brief   The sustainable rate of each mode. */
+        AdaptiveRate rate = new AdaptiveRate(Enum.GetValues(typeof(modes)).Length);
+
+        /** @brief   The garbage collections. */
+        GcMonitor gc = new GcMonitor();
+
+        /** @brief   The transfers of each leg. */
+        BusMetrics metrics = new BusMetrics();
+
+        /** @brief   Serves the metrics on localhost (null if off). */
+        MetricsEndpoint endpoint = null;
+
+        /** @brief   Records every tick (null if off). */
+        FlightRecorder recorder = null;
+        #endregion Objects
+
+        #region Fields
+        /** @brief   The x-axis input. */
+        double x = 0;
+
+        /** @brief   The y-axis input. */
+        double y = 0;
+
+        /** @brief   The z-axis input. */
+        double z = 0;
+
+        /** @brief   The a-axis input. */
+        double a = 0;
+
+        /** @brief   The b-axis input */
+        double b = 0;
+
+        /** @brief   The threshold for the input. */
+        const double threshold = 0.25;
+
+        /** @brief   The timeframe in microseconds */
+        const long timeframe = 25000;
+
+        /** @brief   The timeframe in SUPERFAST mode in microseconds (limits the load of the i2c bus) */
+        const long minTimeframe = 2500;
+
+        /** @brief   The maximum number of frames queued for the bus thread. */
+        const int pipelineCapacity = 64;
+
+        /** @brief   The maximum phase advance per tick (in steps of the reference timeframe). */
+        const double maxPhase = 10;
+
+        /** @brief   The operating mode. */
+        byte mode = 0;
+
+        /** @brief   The movement. */
+        byte direction = 0;
+
+        /** @brief   The movement of the last tick (ticks that change it center the legs and are not measured). */
+        byte lastDirection = 255;
+
+        /** @brief   The phase advance per tick relative to the reference timeframe of the mode. */
+        double phase = 1;
+
+        /** @brief   The time of the last latency log (stopwatch ticks). */
+        long latencyLogTime = Stopwatch.GetTimestamp();
+
+        /** @brief   The time between two latency logs in seconds. */
+        const int latencyLogInterval = 60;
+
+        #endregion Fields
+
+        #region Enums
+
+
+
+        /**
+         * @enum    directions
+         *
+         * @brief   Values that represent directions
+         */
+
+        public enum directions { POSE, XY, ROTATE, TURN };
+        //******
+
+        /**
+         * @enum    modes
+         *
+         * @brief   Values that represent modes
+         */
+
+        public enum modes { DEFAULT, TERRAIN, BALANCE, FAST, SUPERFAST };
+
+        /**
+         * @enum    buttons
+         *
+         * @brief   Values that represent the buttons of the gamepad (same bits as Windows.Gaming.Input.GamepadButtons)
+         */
+
+        [Flags]
+        public enum buttons
+        {
+            NONE = 0, MENU = 1, VIEW = 2, A = 4, B = 8, X = 16, Y = 32,
+            DPADUP = 64, DPADDOWN = 128, DPADLEFT = 256, DPADRIGHT = 512,
+            LEFTSHOULDER = 1024, RIGHTSHOULDER = 2048, LEFTTHUMBSTICK = 4096, RIGHTTHUMBSTICK = 8192
+        };
+
+        #endregion Enums
+
+        #region Properties
+
+        /**
+         * @property    public Action ShutdownRequested
+         *
+         * @brief   Gets or sets the handler that shuts down the system (called after the robot was shut down)
+         *
+         * @return  The shutdown handler.
+         */
+
+        public Action ShutdownRequested { get; set; }
+
+        /**
+         * @property    public TickScheduler Scheduler
+         *
+         * @brief   Gets the scheduler of the input task (rate, overruns and jitter)
+         *
+         * @return  The scheduler.
+         */
+
+        public TickScheduler Scheduler
+        {
+            get { return scheduler; }
+        }
+
+        /**
+         * @property    public AdaptiveRate Rate
+         *
+         * @brief   Gets the measured bus time and duration of the ticks per mode
+         *
+         * @return  The estimates.
+         */
+
+        public AdaptiveRate Rate
+        {
+            get { return rate; }
+        }
+
+        /**
+         * @property    public bool Adaptive
+         *
+         * @brief   Gets or sets whether the timeframe follows the measured bus time.
+         *          Otherwise the reference timeframes are used (reproducible runs).
+         *
+         * @return  True if adaptive.
+         */
+
+        public bool Adaptive { get; set; } = true;
+
+        /**
+         * @property    public bool Pipelined
+         *
+         * @brief   Gets or sets whether the frames are sent by a bus thread, so the next tick is calculated
+         *          while the current one is transmitted (set before init()).
+         *
+         * @return  True if pipelined.
+         */
+
+        public bool Pipelined { get; set; }
+
+        /**
+         * @property    public PipelinedBackend Pipeline
+         *
+         * @brief   Gets the bus thread
+         *
+         * @return  The pipeline or null if not pipelined.
+         */
+
+        public PipelinedBackend Pipeline
+        {
+            get { return pipeline; }
+        }
+
+        /**
+         * @property    public TickPipeline Stages
+         *
+         * @brief   Gets the stages of a tick of the robot (time of each stage)
+         *
+         * @return  The stages.
+         */
+
+        public TickPipeline Stages
+        {
+            get { return robot.Pipeline; }
+        }
+
+        /**
+         * @property    public GcMonitor Memory
+         *
+         * @brief   Gets the garbage collections and their pause time
+         *
+         * @return  The monitor.
+         */
+
+        public GcMonitor Memory
+        {
+            get { return gc; }
+        }
+
+        /**
+         * @property    public long InputTimestamp
+         *
+         * @brief   Gets the time of the input reading of the last tick
+         *
+         * @return  The timestamp (stopwatch ticks, 0 if no input device was connected).
+         */
+
+        public long InputTimestamp { get; private set; }
+
+        /**
+         * @property    public BusMetrics Metrics
+         *
+         * @brief   Gets the transfers of each leg and the load of the bus
+         *
+         * @return  The metrics.
+         */
+
+        public BusMetrics Metrics
+        {
+            get { return metrics; }
+        }
+
+        /**
+         * @property    public int MetricsPort
+         *
+         * @brief   Gets or sets the port of the metrics on localhost (set before init(), 0 = off)
+         *
+         * @return  The port.
+         */
+
+        public int MetricsPort { get; set; }
+
+        /**
+         * @property    public IMetricsListener MetricsListener
+         *
+         * @brief   Gets or sets the listener of the metrics endpoint (set before init(),
+         *          TcpListener on .NET Core, the UWP app sets its own)
+         *
+         * @return  The listener (null = no endpoint).
+         */
+
+#if NETCOREAPP3_0_OR_GREATER
+        public IMetricsListener MetricsListener { get; set; } = new TcpMetricsListener();
+#else
+        public IMetricsListener MetricsListener { get; set; }
+#endif
+
+        /**
+         * @property    public string RecorderPath
+         *
+         * @brief   Gets or sets the file of the flight recorder (set before init(), null = off)
+         *
+         * @return  The path.
+         */
+
+        public string RecorderPath { get; set; }
+
+        /**
+         * @property    public int RecorderCapacity
+         *
+         * @brief   Gets or sets the number of ticks the flight recorder keeps (set before init())
+         *
+         * @return  The number of records.
+         */
+
+        public int RecorderCapacity { get; set; } = 16384;
+
+        /**
+         * @property    public FlightRecorder Recorder
+         *
+         * @brief   Gets the flight recorder
+         *
+         * @return  The flight recorder (null if off).
+         */
+
+        public FlightRecorder Recorder
+        {
+            get { return recorder; }
+        }
+
+        /**
+         * @property    public BalanceController Balance
+         *
+         * @brief   Gets the balance controller of the robot (gains and limit)
+         *
+         * @return  The balance controller.
+         */
+
+        public BalanceController Balance
+        {
+            get { return robot.Balance; }
+        }
+
+        #endregion Properties
+
+        #region Functions
+
+
+        /**
+         * @fn  public Controller(IInputSource input, IImu accel, IActuatorBackend backend)
+         *
+         * @brief   Constructor
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   input   The input device.
+         * @param   accel   The accelerometer.
+         * @param   backend The actuators.
+         */
+
+        public Controller(IInputSource input, IImu accel, IActuatorBackend backend)
+        {
+            this.input = input;
+            this.accel = busTimer.wrap(accel);
+            this.backend = busTimer.wrap(metrics.wrap(backend));
+        }
+
+
+
+        /**
+         * @fn  public void init()
+         *
+         * @brief   Initializes this object
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         */
+
+        public void init()
+        {
+            if (Pipelined)
+            {
+                pipeline = new PipelinedBackend(backend, pipelineCapacity);
+                robot.init(pipeline, accel);
+            }
+            else
+            {
+                robot.init(backend, accel);
+            }
+
+            if (MetricsPort > 0 && MetricsListener == null)
+            {
+                Debug.WriteLine("Error: Metrics endpoint without a listener!");
+            }
+            else if (MetricsPort > 0)
+            {
+                try
+                {
+                    endpoint = new MetricsEndpoint(MetricsListener, writeMetrics);
+                    endpoint.start(MetricsPort);
+                }
+                catch (Exception e)
+                {
+                    endpoint = null;
+                    Debug.WriteLine("Error: Metrics endpoint failed! " + e.Message);
+                }
+            }
+
+            if (RecorderPath != null)
+            {
+                try
+                {
+                    recorder = new FlightRecorder();
+                    recorder.open(RecorderPath, RecorderCapacity);
+                    robot.Recorder = recorder;
+                }
+                catch (Exception e)
+                {
+                    recorder = null;
+                    Debug.WriteLine("Error: Flight recorder failed! " + e.Message);
+                }
+            }
+        }
+
+
+
+        /**
+         * @fn  public void start()
+         *
+         * @brief   Starts the input task (fixed update of the robot)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void start()
+        {
+            inputTask = Task.Factory.StartNew(() => handleInputs());
+        }
+
+
+
+        /**
+         * @fn  public void stop()
+         *
+         * @brief   Stops the input task, waits until the current tick is finished, sends the queued frames and
+         *          ends the bus thread, closes the flight recorder and the metrics endpoint
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void stop()
+        {
+            scheduler.stop();
+            if (inputTask != null)
+            {
+                inputTask.Wait();
+                inputTask = null;
+            }
+            if (pipeline != null)
+            {
+                pipeline.stop();
+            }
+            if (recorder != null)
+            {
+                robot.Recorder = null;
+                recorder.close();
+                recorder = null;
+            }
+            if (endpoint != null)
+            {
+                endpoint.stop();
+                endpoint = null;
+            }
+        }
+
+
+
+        /**
+         * @fn  private void handleInputs()
+         *
+         * @brief   Inputhandler 
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         */
+
+        private void handleInputs()
+        {
+            //fixed update -> necessary for PID-controller
+            scheduler.run(tick);
+        }
+
+
+
+        /**
+         * @fn  public void tick()
+         *
+         * @brief   Reads the input once and moves the robot one step (called by the input task or a headless host)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void tick()
+        {
+            long start = Stopwatch.GetTimestamp();
+            InputState inputState;
+
+            //if an input device is connected
+            bool connected = input.read(out inputState);
+            InputTimestamp = connected ? inputState.Timestamp : 0;
+            if (connected)
+            {
+                //Set all input axis
+                x = -inputState.LeftThumbstickY;
+                y = inputState.LeftThumbstickX;
+                z = (inputState.LeftTrigger - inputState.RightTrigger);
+                a = inputState.RightThumbstickX;
+                b = inputState.RightThumbstickY;
+
+
+
+                //set action accodring to button combos
+
+                //Shutdown = A&B&X&Y&LThumb
+                if (inputState.Buttons == (buttons.A | buttons.B | buttons.X | buttons.Y | buttons.LEFTTHUMBSTICK))
+                {
+                    //Shutdown the system
+                    shutdown();
+                }
+                //Super fast = Left Stick and Right Stick
+                else if (inputState.Buttons == (buttons.LEFTTHUMBSTICK | buttons.RIGHTTHUMBSTICK))
+                {
+                    mode = (byte)modes.SUPERFAST;
+                }
+                //Fast = Right Stick
+                else if (inputState.Buttons == buttons.RIGHTTHUMBSTICK)
+                {
+                    mode = (byte)modes.FAST;
+                }
+                //Pose = RightShoulder
+                else if (inputState.Buttons == buttons.RIGHTSHOULDER)
+                {
+                    mode = (byte)modes.BALANCE;
+                }
+                //Terrain = LeftShoulder
+                else if (inputState.Buttons == buttons.LEFTSHOULDER)
+                {
+                    mode = (byte)modes.TERRAIN;
+                }
+                else
+                {
+                    mode = (byte)modes.DEFAULT;
+                }
+
+
+                if (inputState.Buttons == buttons.DPADUP)
+                {
+                    direction = (byte)directions.XY;
+                }
+                else if (inputState.Buttons == buttons.DPADLEFT)
+                {
+                    direction = (byte)directions.POSE;
+                }
+                else if (inputState.Buttons == buttons.DPADDOWN)
+                {
+                    direction = (byte)directions.ROTATE;
+                }
+                else if (inputState.Buttons == buttons.DPADRIGHT)
+                {
+                    direction = (byte)directions.TURN;
+                }
+
+            }
+
+            //run at the highest sustainable rate, move at the speed of the reference timeframe
+            scheduler.Period = getTimeframe(mode);
+            phase = Math.Min(maxPhase, (double)scheduler.Period / getReferenceTimeframe(mode));
+            robot.Period = scheduler.Period;
+            robot.InputTimestamp = InputTimestamp;
+
+            switch (direction)
+            {
+                case (byte)directions.XY:
+                    walk(mode);
+                    break;
+                case (byte)directions.ROTATE:
+                    rotate(mode);
+                    break;
+                case (byte)directions.TURN:
+                    turn(mode);
+                    break;
+                case (byte)directions.POSE:
+                    pose(mode);
+                    break;
+                default:
+                    break;
+            }
+
+            long bus = busTimer.take();
+            if (direction == lastDirection)
+            {
+                rate.record(getRateMode(mode), bus, Stopwatch.GetTimestamp() - start);
+            }
+            lastDirection = direction;
+            metrics.recordTick(bus, scheduler.Period);
+            gc.update();
+            metrics.update();
+            logLatency();
+        }
+
+
+
+        /**
+         * @fn  public void writeMetrics(TextWriter writer)
+         *
+         * @brief   Writes the metrics in the Prometheus text format (transfers of each leg, load of the bus,
+         *          latency of the stages)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   writer  The writer.
+         */
+
+        public void writeMetrics(TextWriter writer)
+        {
+            metrics.write(writer);
+
+            writer.Write("# HELP hexpi_stage_latency_microseconds Time from the input reading to the end of a stage.\n");
+            writer.Write("# TYPE hexpi_stage_latency_microseconds gauge\n");
+            foreach (TickPipeline.stages stage in Enum.GetValues(typeof(TickPipeline.stages)))
+            {
+                LatencyHistogram.Summary s = robot.Pipeline.getLatency(stage);
+                string name = stage.ToString().ToLower();
+                writer.Write(string.Format(System.Globalization.CultureInfo.InvariantCulture,
+                    "hexpi_stage_latency_microseconds{{stage=\"{0}\",quantile=\"0.5\"}} {1}\nhexpi_stage_latency_microseconds{{stage=\"{0}\",quantile=\"0.99\"}} {2}\nhexpi_stage_latency_microseconds{{stage=\"{0}\",quantile=\"1\"}} {3}\n",
+                    name, s.P50, s.P99, s.Max));
+            }
+        }
+
+
+
+        /**
+         * @fn  private long getTimeframe(byte mode)
+         *
+         * @brief   Gets the timeframe of a mode. Adaptive, every mode starts at its reference timeframe and runs
+         *          at the highest sustainable rate once it was measured (the phase keeps the speed of the legs),
+         *          never faster than the servo signals of the backend and TERRAIN never faster than its reference
+         *          timeframe. Otherwise the reference timeframe of the mode is used.
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   mode    The mode.
+         *
+         * @return  The timeframe in microseconds.
+         */
+
+        private long getTimeframe(byte mode)
+        {
+            if (!Adaptive)
+            {
+                return getReferenceTimeframe(mode);
+            }
+
+            long min = Math.Max(minTimeframe, backend.FramePeriod);
+            long sustainable = rate.getTimeframe(getRateMode(mode), min, getReferenceTimeframe(mode));
+            //the legs sense the ground within half of the timeframe (FeedbackStage), a shorter one cuts the sensing short
+            if (mode == (byte)modes.TERRAIN)
+            {
+                return Math.Max(getReferenceTimeframe(mode), sustainable);
+            }
+            return sustainable;
+        }
+
+
+
+        /**
+         * @fn  private long getReferenceTimeframe(byte mode)
+         *
+         * @brief   Gets the reference timeframe of a mode (the gait moves one step per reference timeframe)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   mode    The mode.
+         *
+         * @return  The timeframe in microseconds.
+         */
+
+        private long getReferenceTimeframe(byte mode)
+        {
+            switch (mode)
+            {
+                case (byte)modes.FAST:
+                    return timeframe / 3;
+                case (byte)modes.SUPERFAST:
+                    return minTimeframe;
+                default:
+                    return timeframe;
+            }
+        }
+
+
+
+        /**
+         * @fn  private byte getRateMode(byte mode)
+         *
+         * @brief   Gets the mode whose bus load is measured (FAST and SUPERFAST send the same data as DEFAULT)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   mode    The mode.
+         *
+         * @return  The measured mode.
+         */
+
+        private byte getRateMode(byte mode)
+        {
+            if (mode == (byte)modes.FAST || mode == (byte)modes.SUPERFAST)
+            {
+                return (byte)modes.DEFAULT;
+            }
+            return mode;
+        }
+
+
+
+        /**
+         * @fn  private void logLatency()
+         *
+         * @brief   Logs the latency from the input reading to the end of the transmit stage once a minute
+         *          (percentiles since the last reset of the stages)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        private void logLatency()
+        {
+            long now = Stopwatch.GetTimestamp();
+            if (now - latencyLogTime < latencyLogInterval * Stopwatch.Frequency)
+            {
+                return;
+            }
+            latencyLogTime = now;
+
+            LatencyHistogram.Summary s = robot.Pipeline.getLatency(TickPipeline.stages.TRANSMIT);
+            Debug.WriteLine("Info: Latency input to transmit: p50 {0:F0}us  p99 {1:F0}us  max {2:F0}us  ({3} ticks)",
+                s.P50, s.P99, s.Max, s.Count);
+        }
+
+
+
+        /**
+         * @fn  private void shutdown()
+         *
+         * @brief   Shuts down this system
+         *
+         * @author  Alex
+         * @date    13.08.2017
+         */
+
+        private void shutdown()
+        {
+            Debug.WriteLine("WARNING: SYSTEM SHUTDOWN INITIALIZED!");
+
+            robot.shutdown();
+
+            ShutdownRequested?.Invoke();
+        }
+
+
+
+        /**
+         * @fn  private void walk(byte mode)
+         *
+         * @brief   Walks in the given mode
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         *
+         * @param   mode    The mode.
+         */
+
+        private void walk(byte mode)
+        {
+            //check if any of the axis is above the threshold
+            if (Math.Abs(x) >= threshold || Math.Abs(y) >= threshold)
+            {
+                //if only x is above the threshold
+                if (((Math.Abs(x) >= threshold) && !(Math.Abs(y) >= threshold)))
+                {
+                    //walk in x direction in the given mode
+
+                    robot.walk(x * phase, 0, mode);
+                }
+                //if only y is above threshold
+                else if (((Math.Abs(y) >= threshold) && !(Math.Abs(x) >= threshold)))
+                {
+                    //walk in y direction in the given mode
+
+                    robot.walk(0, y * phase, mode);
+                }
+                else
+                {
+                    //walk in xy direction in the given mode
+
+                    robot.walk(x * phase, y * phase, mode);
+                }
+
+            }
+            else
+            {
+                //dont move
+                robot.walk(0, 0, mode);
+            }
+        }
+
+        /**
+         * @fn  private void turn(byte mode)
+         *
+         * @brief   Turns in the given mode
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         *
+         * @param   mode    The mode.
+         */
+
+        private void turn(byte mode)
+        {
+
+            if (Math.Abs(x) >= threshold && !(Math.Abs(a) >= threshold))
+            {
+                //walk
+                robot.turn(x * phase, 0, mode);
+            }
+            else if (Math.Abs(x) >= threshold && (Math.Abs(a) >= threshold))
+            {
+                //turn 
+                robot.turn(x * phase, a, mode);
+            }
+            else
+            {
+                //dont move
+                robot.turn(0, 0, mode);
+            }
+
+        }
+
+        /**
+         * @fn  private void rotate(byte mode)
+         *
+         * @brief   Rotates in the given mode
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         *
+         * @param   mode    The mode.
+         */
+
+        private void rotate(byte mode)
+        {
+            if (Math.Abs(y) >= threshold)
+            {
+                //rotate in given direction in the given mode
+                robot.rotate(y * phase, mode);
+            }
+            else
+            {
+                //dont move
+                robot.rotate(0, mode);
+            }
+
+        }
+
+
+        /**
+         * @fn  private void pose()
+         *
+         * @brief   Poses the Hexapod
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         */
+
+        private void pose(byte mode)
+        {
+            //1° = 0,0174533 rad
+            double degX = 0.174533 * y;
+            double degY = 0.174533 * -x;
+            double degZ = 0.174533 * z;
+            double distA = 30 * b;
+            double distB = 30 * -a;
+            double distC = 0;
+            //Set rotation around xyz axis and translation in ab-axis
+            robot.pose(degZ, degY, degX, distA, distB, distC, mode);
+        }
+
+        #endregion Functions
+    }
+}
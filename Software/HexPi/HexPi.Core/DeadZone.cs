@@ -0,0 +1,83 @@
+﻿/**********************************************************************************************//**
+ * @file    DeadZone.cs
+ *
+ * @brief   Implements the dead zone class.
+ **************************************************************************************************/
+
+using System;
+
+namespace HexPi
+{
+
+    /**
+     * @class   DeadZone
+     *
+     * @brief   Shapes the axes of an input device. Values inside the dead zone are 0, the rest is scaled to
+     *          0 - 1 again, so a stick starts moving the robot slowly instead of jumping to the size of the
+     *          dead zone. A thumbstick uses a radial dead zone (the direction stays the same).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    static class DeadZone
+    {
+        #region FUNCTIONS
+
+        /**
+         * @fn  public static double apply(double value, double size)
+         *
+         * @brief   Shapes one axis or trigger
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   value   The value (-1 - 1).
+         * @param   size    The size of the dead zone (0 - 1).
+         *
+         * @return  The shaped value.
+         */
+
+        public static double apply(double value, double size)
+        {
+            double magnitude = Math.Abs(value);
+            if (magnitude <= size)
+            {
+                return 0;
+            }
+            return Math.Sign(value) * Math.Min(1, (magnitude - size) / (1 - size));
+        }
+
+
+
+        /**
+         * @fn  public static void apply(ref double x, ref double y, double size)
+         *
+         * @brief   Shapes a thumbstick
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param [in,out]  x       The x-axis.
+         * @param [in,out]  y       The y-axis.
+         * @param           size    The radius of the dead zone (0 - 1).
+         */
+
+        public static void apply(ref double x, ref double y, double size)
+        {
+            double magnitude = Math.Sqrt(x * x + y * y);
+            if (magnitude <= size)
+            {
+                x = 0;
+                y = 0;
+                return;
+            }
+
+            double scale = Math.Min(1, (magnitude - size) / (1 - size)) / magnitude;
+            x *= scale;
+            y *= scale;
+        }
+
+        #endregion FUNCTIONS
+    }
+}
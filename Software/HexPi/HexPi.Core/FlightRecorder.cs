@@ -0,0 +1,396 @@
+﻿/**********************************************************************************************//**
+ * @file    FlightRecorder.cs
+ *
+ * @brief   Implements the flight recorder class.
+ **************************************************************************************************/
+
+using System;
+using System.Diagnostics;
+using System.IO;
+#if NETCOREAPP3_0_OR_GREATER
+using System.IO.MemoryMappedFiles;
+#endif
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace HexPi
+{
+
+    /**
+     * @class   FlightRecorder
+     *
+     * @brief   Records every tick in a ring of fixed-size binary records in a file: the command, the IMU sample,
+     *          the output of the balance controller, the tcp position and the last frame of each leg and the
+     *          time of each stage. The oldest record is overwritten when the ring is full.
+     *          The control thread only copies the record into the ring. The file is memory-mapped
+     *          (.NET Core 3 and later), so the records survive a crash of the process, and a background thread
+     *          writes the pages to the disk once a second. The UWP framework has no memory-mapped files,
+     *          there the ring is kept in memory and the background thread writes the new records to the file.
+     *
+     *          File: header (HeaderSize bytes) + Capacity records (RecordSize bytes), little endian.
+     *          Header: int magic "HXFR", int version, int record size, int capacity,
+     *                  long stopwatch frequency, long sequence number of the last record.
+     *          Record: see record(). The decoder of the host exports it as CSV (--decode).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class FlightRecorder
+    {
+        #region Objects
+#if NETCOREAPP3_0_OR_GREATER
+        /** @brief   The file. */
+        MemoryMappedFile file = null;
+
+        /** @brief   The view of the whole file. */
+        MemoryMappedViewAccessor view = null;
+#else
+        /** @brief   The file. */
+        FileStream file = null;
+#endif
+
+        /** @brief   Writes the file to the disk. */
+        Task thread = null;
+
+        /** @brief   Wakes the background thread on close(). */
+        ManualResetEvent closing = new ManualResetEvent(false);
+        #endregion Objects
+
+        #region FIELDS
+        /** @brief   The sequence number of the last record (1 = first record). */
+        private long sequence = 0;
+
+#if !NETCOREAPP3_0_OR_GREATER
+        /** @brief   The sequence number of the last record in the file. */
+        private long written = 0;
+#endif
+        #endregion FIELDS
+
+        #region CONSTANTS
+        /** @brief   The magic number at the start of the file ("HXFR"). */
+        public const int Magic = 0x52465848;
+
+        /** @brief   The version of the format. */
+        public const int Version = 1;
+
+        /** @brief   The size of the header in bytes. */
+        public const int HeaderSize = 64;
+
+        /** @brief   The size of a record in bytes. */
+        public const int RecordSize = 216;
+
+        /** @brief   The number of legs in a record. */
+        public const int Legs = 6;
+
+        /** @brief   The size of the frame of a leg in a record. */
+        public const int FrameSize = 4;
+
+        /** @brief   The number of stages in a record (TickPipeline.stages). */
+        public const int Stages = 6;
+
+        /** @brief   The number of floats in a record. */
+        private const int valueCount = 9 + 4 + 2 + 3 * Legs + Stages;
+
+        /** @brief   The offset of the floats in a record. */
+        private const int valueOffset = 36;
+
+        /** @brief   The offset of the frames in a record. */
+        private const int frameOffset = valueOffset + valueCount * 4;
+
+        /** @brief   The offset of the sequence number in the header. */
+        private const int sequenceOffset = 24;
+
+        /** @brief   The time between two writes to the disk in milliseconds. */
+        private const int flushInterval = 1000;
+        #endregion CONSTANTS
+
+        #region Arrays
+        /** @brief   The current record. */
+        private byte[] buffer = new byte[RecordSize];
+
+        /** @brief   The timestamps of the current record. */
+        private long[] times = new long[4];
+
+        /** @brief   The floats of the current record. */
+        private float[] values = new float[valueCount];
+
+#if !NETCOREAPP3_0_OR_GREATER
+        /** @brief   The ring of records. */
+        private byte[] ring = null;
+#endif
+        #endregion Arrays
+
+        #region PROPERTIES
+
+        /**
+         * @property    public int Capacity
+         *
+         * @brief   Gets the number of records in the ring
+         *
+         * @return  The capacity.
+         */
+
+        public int Capacity { get; private set; }
+
+        /**
+         * @property    public long Count
+         *
+         * @brief   Gets the number of records since the start (the ring holds the last Capacity ones)
+         *
+         * @return  The number of records.
+         */
+
+        public long Count
+        {
+            get { return Volatile.Read(ref sequence); }
+        }
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public void open(string path, int capacity)
+         *
+         * @brief   Creates the file (an existing one is replaced) and starts the background thread
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   path        The path of the file.
+         * @param   capacity    The number of records in the ring (16384 = about 7 minutes at 40 Hz).
+         */
+
+        public void open(string path, int capacity)
+        {
+            Capacity = capacity;
+            long size = HeaderSize + (long)capacity * RecordSize;
+
+            byte[] header = new byte[HeaderSize];
+            using (BinaryWriter h = new BinaryWriter(new MemoryStream(header)))
+            {
+                h.Write(Magic);
+                h.Write(Version);
+                h.Write(RecordSize);
+                h.Write(capacity);
+                h.Write(Stopwatch.Frequency);
+                h.Write(0L);
+            }
+
+#if NETCOREAPP3_0_OR_GREATER
+            using (FileStream stream = new FileStream(path, FileMode.Create, FileAccess.ReadWrite, FileShare.Read))
+            {
+                stream.SetLength(size);
+                stream.Write(header, 0, header.Length);
+            }
+            file = MemoryMappedFile.CreateFromFile(path, FileMode.Open, null, size, MemoryMappedFileAccess.ReadWrite);
+            view = file.CreateViewAccessor(0, size);
+#else
+            ring = new byte[(long)capacity * RecordSize];
+            file = new FileStream(path, FileMode.Create, FileAccess.Write, FileShare.Read);
+            file.SetLength(size);
+            file.Write(header, 0, header.Length);
+            file.Flush();
+#endif
+
+            thread = Task.Factory.StartNew(run, TaskCreationOptions.LongRunning);
+            Debug.WriteLine("Info: Flight recorder {0} ({1} records)", path, capacity);
+        }
+
+
+
+        /**
+         * @fn  public void record(TickCommand command, bool transition, IImu imu, BalanceController balance, BodyKinematics body, Leg[] legs, TickPipeline pipeline)
+         *
+         * @brief   Records a tick (control thread, does not allocate or wait)
+         *          Layout: long sequence, long start of the tick, long input timestamp, long IMU timestamp
+         *          (stopwatch ticks), byte direction, byte mode, byte transition, byte reserved,
+         *          float x, y, r, yaw, pitch, roll, a, b, c (command), float pitch, roll, pitch rate, roll rate (IMU),
+         *          float pitch, roll (balance), Legs x (float x, y, z of the tcp),
+         *          Stages x (float time of the stage in microseconds), Legs x (FrameSize bytes frame).
+         *          The fields are copied in blocks in the byte order of the machine (little endian).
+         *          The sequence number of the slot is 0 while the record is written (seqlock), a reader
+         *          keeps a record only if its sequence number is the same before and after reading it.
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   command     The command of the tick.
+         * @param   transition  True if the legs moved to the center.
+         * @param   imu         The accelerometer.
+         * @param   balance     The balance controller.
+         * @param   body        The tcp positions.
+         * @param   legs        The legs.
+         * @param   pipeline    The stages (time of the tick).
+         */
+
+        public void record(TickCommand command, bool transition, IImu imu, BalanceController balance, BodyKinematics body, Leg[] legs, TickPipeline pipeline)
+        {
+            long next = sequence + 1;
+
+            times[0] = next;
+            times[1] = pipeline.LastTick;
+            times[2] = command.InputTimestamp;
+            times[3] = imu.Timestamp;
+            Buffer.BlockCopy(times, 0, buffer, 0, 4 * sizeof(long));
+            buffer[32] = command.Direction;
+            buffer[33] = command.Mode;
+            buffer[34] = (byte)(transition ? 1 : 0);
+            buffer[35] = 0;
+
+            int v = 0;
+            values[v++] = (float)command.X;
+            values[v++] = (float)command.Y;
+            values[v++] = (float)command.R;
+            values[v++] = (float)command.Yaw;
+            values[v++] = (float)command.Pitch;
+            values[v++] = (float)command.Roll;
+            values[v++] = (float)command.A;
+            values[v++] = (float)command.B;
+            values[v++] = (float)command.C;
+            values[v++] = (float)imu.Pitch;
+            values[v++] = (float)imu.Roll;
+            values[v++] = (float)imu.PitchRate;
+            values[v++] = (float)imu.RollRate;
+            values[v++] = (float)balance.Pitch;
+            values[v++] = (float)balance.Roll;
+            for (int i = 0; i < Legs; i++)
+            {
+                values[v++] = (float)body.X[i];
+                values[v++] = (float)body.Y[i];
+                values[v++] = (float)body.Z[i];
+            }
+            double us = 1000000.0 / Stopwatch.Frequency;
+            for (int i = 0; i < Stages; i++)
+            {
+                values[v++] = (float)(pipeline.getTime((TickPipeline.stages)i) * us);
+            }
+            Buffer.BlockCopy(values, 0, buffer, valueOffset, values.Length * sizeof(float));
+
+            for (int i = 0; i < Legs; i++)
+            {
+                Buffer.BlockCopy(legs[i].PositionFrame, 0, buffer, frameOffset + i * FrameSize, FrameSize);
+            }
+
+            long offset = HeaderSize + (next - 1) % Capacity * RecordSize;
+#if NETCOREAPP3_0_OR_GREATER
+            view.Write(offset, 0L);
+            Interlocked.MemoryBarrier();
+            view.WriteArray(offset + sizeof(long), buffer, sizeof(long), RecordSize - sizeof(long));
+            Interlocked.MemoryBarrier();
+            view.Write(offset, next);
+            view.Write(sequenceOffset, next);
+#else
+            int slot = (int)(offset - HeaderSize);
+            Array.Clear(ring, slot, sizeof(long));
+            Interlocked.MemoryBarrier();
+            Buffer.BlockCopy(buffer, sizeof(long), ring, slot + sizeof(long), RecordSize - sizeof(long));
+            Interlocked.MemoryBarrier();
+            Buffer.BlockCopy(buffer, 0, ring, slot, sizeof(long));
+#endif
+            Volatile.Write(ref sequence, next);
+        }
+
+
+
+        /**
+         * @fn  public void close()
+         *
+         * @brief   Stops the background thread, writes the remaining records and closes the file
+         *          (after the last tick)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void close()
+        {
+            if (thread == null)
+            {
+                return;
+            }
+            closing.Set();
+            thread.Wait();
+            thread = null;
+
+#if NETCOREAPP3_0_OR_GREATER
+            view.Dispose();
+            file.Dispose();
+#else
+            file.Dispose();
+#endif
+            file = null;
+        }
+
+
+
+        /**
+         * @fn  private void run()
+         *
+         * @brief   Writes the file to the disk once a second until the recorder is closed
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        private void run()
+        {
+            bool closed = false;
+            while (!closed)
+            {
+                closed = closing.WaitOne(flushInterval);
+                try
+                {
+                    flush();
+                }
+                catch (Exception e)
+                {
+                    Debug.WriteLine("Error: Flight recorder flush failed! " + e.Message);
+                }
+            }
+        }
+
+
+
+        /**
+         * @fn  private void flush()
+         *
+         * @brief   Writes the records since the last flush to the disk (background thread)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        private void flush()
+        {
+#if NETCOREAPP3_0_OR_GREATER
+            view.Flush();
+#else
+            long last = Volatile.Read(ref sequence);
+            if (last == written)
+            {
+                return;
+            }
+
+            //only the last Capacity records are in the ring, in at most two parts
+            long first = Math.Max(written + 1, last - Capacity + 1);
+            while (first <= last)
+            {
+                int slot = (int)((first - 1) % Capacity);
+                int count = (int)Math.Min(last - first + 1, Capacity - slot);
+                file.Seek(HeaderSize + (long)slot * RecordSize, SeekOrigin.Begin);
+                file.Write(ring, slot * RecordSize, count * RecordSize);
+                first += count;
+            }
+
+            file.Seek(sequenceOffset, SeekOrigin.Begin);
+            file.Write(BitConverter.GetBytes(last), 0, 8);
+            file.Flush();
+            written = last;
+#endif
+        }
+
+        #endregion FUNCTIONS
+    }
+}
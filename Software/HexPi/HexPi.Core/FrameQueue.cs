@@ -0,0 +1,211 @@
+﻿/**********************************************************************************************//**
+ * @file    FrameQueue.cs
+ *
+ * @brief   Implements the frame queue class.
+ **************************************************************************************************/
+
+using System.Threading;
+
+namespace HexPi
+{
+
+    /**
+     * @class   FrameQueue
+     *
+     * @brief   A bounded lock-free queue of frames for one producer (control thread) and one consumer (bus thread).
+     *          The frames are preallocated and copied into the queue, the producer may reuse its buffers at once.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class FrameQueue
+    {
+
+        /**
+         * @class   Frame
+         *
+         * @brief   A queued frame. Bus = null marks the end of a tick (flush).
+         */
+
+        public class Frame
+        {
+            /** @brief   The bus of the leg. */
+            public ILegBus Bus;
+            /** @brief   The data (one buffer per length, reused). */
+            public byte[] Data;
+            /** @brief   The timestamp of the enqueue (stopwatch ticks). */
+            public long Timestamp;
+            /** @brief   The buffers by length. */
+            private byte[][] buffers = new byte[maxLength + 1][];
+
+            /**
+             * @fn  public void set(ILegBus bus, byte[] data, long timestamp)
+             *
+             * @brief   Copies a frame into the queue
+             *
+             * @param   bus         The bus of the leg (null = flush).
+             * @param   data        The data (null = flush).
+             * @param   timestamp   The timestamp.
+             */
+
+            public void set(ILegBus bus, byte[] data, long timestamp)
+            {
+                Bus = bus;
+                Timestamp = timestamp;
+                if (data == null)
+                {
+                    Data = null;
+                    return;
+                }
+                if (data.Length > maxLength)
+                {
+                    Data = (byte[])data.Clone();
+                    return;
+                }
+                if (buffers[data.Length] == null)
+                {
+                    buffers[data.Length] = new byte[data.Length];
+                }
+                Data = buffers[data.Length];
+                System.Buffer.BlockCopy(data, 0, Data, 0, data.Length);
+            }
+        }
+
+        #region CONSTANTS
+        /** @brief   The maximum length of a reused buffer (longer frames are copied). */
+        private const int maxLength = 16;
+        #endregion CONSTANTS
+
+        #region FIELDS
+        /** @brief   The index of the next frame to read (consumer). */
+        private long head = 0;
+
+        /** @brief   The index of the next frame to write (producer). */
+        private long tail = 0;
+
+        /** @brief   The capacity - 1 (capacity is a power of two). */
+        private long mask = 0;
+        #endregion FIELDS
+
+        #region Arrays
+        /** @brief   The frames. */
+        private Frame[] frames;
+        #endregion Arrays
+
+        #region PROPERTIES
+
+        /**
+         * @property    public int Count
+         *
+         * @brief   Gets the number of queued frames
+         *
+         * @return  The number of frames.
+         */
+
+        public int Count
+        {
+            get { return (int)(Volatile.Read(ref tail) - Volatile.Read(ref head)); }
+        }
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public FrameQueue(int capacity)
+         *
+         * @brief   Constructor
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   capacity    The capacity (rounded up to a power of two).
+         */
+
+        public FrameQueue(int capacity)
+        {
+            int size = 1;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            mask = size - 1;
+            frames = new Frame[size];
+            for (int i = 0; i < size; i++)
+            {
+                frames[i] = new Frame();
+            }
+        }
+
+        /**
+         * @fn  public Frame reserve()
+         *
+         * @brief   Gets the next free frame (producer)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The frame or null if the queue is full.
+         */
+
+        public Frame reserve()
+        {
+            if (tail - Volatile.Read(ref head) > mask)
+            {
+                return null;
+            }
+            return frames[tail & mask];
+        }
+
+        /**
+         * @fn  public void publish()
+         *
+         * @brief   Hands the reserved frame to the consumer (producer)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void publish()
+        {
+            Volatile.Write(ref tail, tail + 1);
+        }
+
+        /**
+         * @fn  public Frame peek()
+         *
+         * @brief   Gets the oldest frame (consumer)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The frame or null if the queue is empty.
+         */
+
+        public Frame peek()
+        {
+            if (Volatile.Read(ref tail) == head)
+            {
+                return null;
+            }
+            return frames[head & mask];
+        }
+
+        /**
+         * @fn  public void release()
+         *
+         * @brief   Frees the oldest frame after it was sent (consumer)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void release()
+        {
+            Volatile.Write(ref head, head + 1);
+        }
+
+        #endregion FUNCTIONS
+    }
+}
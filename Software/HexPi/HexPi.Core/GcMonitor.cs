@@ -0,0 +1,268 @@
+﻿/**********************************************************************************************//**
+ * @file    GcMonitor.cs
+ *
+ * @brief   Implements the gc monitor class.
+ **************************************************************************************************/
+
+using System;
+using System.Diagnostics;
+
+namespace HexPi
+{
+
+    /**
+     * @class   GcMonitor
+     *
+     * @brief   Counts the garbage collections and their pause time. A collection pauses the control thread,
+     *          which shows up as stutter in the gait. The counters of the last full minute are logged.
+     *          The pause time (.NET 7) and the allocated bytes (.NET Core 3) are 0 on UWP.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class GcMonitor
+    {
+
+        /**
+         * @struct  Statistics
+         *
+         * @brief   The garbage collections in a time span.
+         */
+
+        public struct Statistics
+        {
+            /** @brief   The time span in seconds. */
+            public double Elapsed;
+            /** @brief   The number of generation 0 collections. */
+            public int Gen0;
+            /** @brief   The number of generation 1 collections. */
+            public int Gen1;
+            /** @brief   The number of generation 2 collections. */
+            public int Gen2;
+            /** @brief   The time the threads were paused in milliseconds. */
+            public double PauseTime;
+            /** @brief   The allocated bytes (all threads). */
+            public long Allocated;
+        }
+
+        /**
+         * @struct  Sample
+         *
+         * @brief   The counters of the runtime at a point in time.
+         */
+
+        private struct Sample
+        {
+            /** @brief   The time (stopwatch ticks). */
+            public long Time;
+            /** @brief   The generation 0 collections. */
+            public int Gen0;
+            /** @brief   The generation 1 collections. */
+            public int Gen1;
+            /** @brief   The generation 2 collections. */
+            public int Gen2;
+            /** @brief   The pause time (TimeSpan ticks). */
+            public long Pause;
+            /** @brief   The allocated bytes. */
+            public long Allocated;
+        }
+
+        #region Objects
+        /** @brief   Lock for the samples. */
+        object sampleLock = new object();
+        #endregion Objects
+
+        #region FIELDS
+        /** @brief   The sample at the last reset. */
+        private Sample start;
+
+        /** @brief   The sample at the start of the current minute. */
+        private Sample minute;
+
+        /** @brief   The counters of the last full minute. */
+        private Statistics lastMinute;
+
+        /** @brief   The start of the current minute (read without lock by update()). */
+        private long minuteStart;
+        #endregion FIELDS
+
+        #region CONSTANTS
+        /** @brief   The length of a log interval in seconds. */
+        private const int interval = 60;
+        #endregion CONSTANTS
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public GcMonitor()
+         *
+         * @brief   Default constructor
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public GcMonitor()
+        {
+            start = take();
+            minute = start;
+            minuteStart = start.Time;
+        }
+
+
+
+        /**
+         * @fn  public void update()
+         *
+         * @brief   Closes the current minute if it is over and logs its counters (called once per tick)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void update()
+        {
+            if (Stopwatch.GetTimestamp() - minuteStart < interval * Stopwatch.Frequency)
+            {
+                return;
+            }
+
+            Statistics s;
+            lock (sampleLock)
+            {
+                Sample now = take();
+                s = difference(minute, now);
+                lastMinute = s;
+                minute = now;
+                minuteStart = now.Time;
+            }
+            Debug.WriteLine("Info: GC last minute: gen0 {0}  gen1 {1}  gen2 {2}  pause {3:F1}ms  allocated {4} bytes",
+                s.Gen0, s.Gen1, s.Gen2, s.PauseTime, s.Allocated);
+        }
+
+
+
+        /**
+         * @fn  public Statistics getStatistics()
+         *
+         * @brief   Gets the collections since the last reset
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The statistics.
+         */
+
+        public Statistics getStatistics()
+        {
+            lock (sampleLock)
+            {
+                return difference(start, take());
+            }
+        }
+
+
+
+        /**
+         * @fn  public Statistics getLastMinute()
+         *
+         * @brief   Gets the collections of the last full minute
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The statistics (empty during the first minute).
+         */
+
+        public Statistics getLastMinute()
+        {
+            lock (sampleLock)
+            {
+                return lastMinute;
+            }
+        }
+
+
+
+        /**
+         * @fn  public void resetStatistics()
+         *
+         * @brief   Resets the statistics
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void resetStatistics()
+        {
+            lock (sampleLock)
+            {
+                start = take();
+            }
+        }
+
+
+
+        /**
+         * @fn  private static Sample take()
+         *
+         * @brief   Reads the counters of the runtime
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The sample.
+         */
+
+        private static Sample take()
+        {
+            Sample s = new Sample();
+            s.Time = Stopwatch.GetTimestamp();
+            s.Gen0 = GC.CollectionCount(0);
+            s.Gen1 = GC.CollectionCount(1);
+            s.Gen2 = GC.CollectionCount(2);
+#if NET7_0_OR_GREATER
+            s.Pause = GC.GetTotalPauseDuration().Ticks;
+#else
+            s.Pause = 0; //not available
+#endif
+#if NETCOREAPP3_0_OR_GREATER
+            s.Allocated = GC.GetTotalAllocatedBytes(false);
+#else
+            s.Allocated = 0; //not available
+#endif
+            return s;
+        }
+
+
+
+        /**
+         * @fn  private static Statistics difference(Sample from, Sample to)
+         *
+         * @brief   Gets the collections between two samples
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   from    The first sample.
+         * @param   to      The second sample.
+         *
+         * @return  The statistics.
+         */
+
+        private static Statistics difference(Sample from, Sample to)
+        {
+            Statistics s = new Statistics();
+            s.Elapsed = (double)(to.Time - from.Time) / Stopwatch.Frequency;
+            s.Gen0 = to.Gen0 - from.Gen0;
+            s.Gen1 = to.Gen1 - from.Gen1;
+            s.Gen2 = to.Gen2 - from.Gen2;
+            s.PauseTime = (double)(to.Pause - from.Pause) / TimeSpan.TicksPerMillisecond;
+            s.Allocated = to.Allocated - from.Allocated;
+            return s;
+        }
+
+        #endregion FUNCTIONS
+    }
+}
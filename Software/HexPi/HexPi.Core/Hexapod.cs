@@ -0,0 +1,714 @@
+﻿/**********************************************************************************************//**
+ * @file    hexapod.cs
+ *
+ * @brief   Implements the hexapod class.
+ **************************************************************************************************/
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace HexPi
+{
+
+    /**
+     * @class   Hexapod
+     *
+     * @brief   A hexapod. Every movement runs through the same stages (see TickPipeline).
+     *
+     * @author  Alexander Miller
+     * @date    13.08.2017
+     */
+
+    class Hexapod
+    {
+
+        /**
+         * @class   InputStage
+         *
+         * @brief   Starts the transition to the center and sets the color of the legs when the direction changes.
+         */
+
+        private class InputStage : ITickStage
+        {
+            /** @brief   The robot. */
+            Hexapod robot;
+
+            public InputStage(Hexapod robot)
+            {
+                this.robot = robot;
+            }
+
+            public void run(TickCommand command)
+            {
+                if (robot.lastDirection == command.Direction)
+                {
+                    return;
+                }
+
+                robot.centerLegs();
+
+                foreach (Leg l in robot.legs)
+                {
+                    l.setColor(getColor(command.Direction));
+                }
+                robot.lastDirection = command.Direction;
+            }
+
+            private static ushort getColor(byte direction)
+            {
+                switch (direction)
+                {
+                    case (byte)Controller.directions.XY:
+                        return 60;
+                    case (byte)Controller.directions.TURN:
+                        return 235;
+                    case (byte)Controller.directions.ROTATE:
+                        return 180;
+                    default:
+                        return 120;
+                }
+            }
+        }
+
+        /**
+         * @class   GaitStage
+         *
+         * @brief   Advances the gait of each leg and calculates the tcp coordinates of all legs
+         *          (pose: all legs in the center). During a transition the planner moves the legs instead,
+         *          the gait starts from the center when it is finished.
+         */
+
+        private class GaitStage : ITickStage
+        {
+            /** @brief   The robot. */
+            Hexapod robot;
+
+            public GaitStage(Hexapod robot)
+            {
+                this.robot = robot;
+            }
+
+            public void run(TickCommand command)
+            {
+                if (robot.planner.Active)
+                {
+                    robot.planner.step(robot.Period);
+                    if (!robot.planner.Active)
+                    {
+                        foreach (Leg l in robot.legs)
+                        {
+                            l.calcPositionCenter();
+                        }
+                    }
+                    return;
+                }
+
+                long start = TickEventSource.Log.begin();
+                foreach (Leg l in robot.legs)
+                {
+                    switch (command.Direction)
+                    {
+                        case (byte)Controller.directions.XY:
+                            l.calcPositionWalk(command.X, command.Y, command.Mode);
+                            break;
+                        case (byte)Controller.directions.TURN:
+                            l.calcPositionTurn(command.X, command.R, command.Mode);
+                            break;
+                        case (byte)Controller.directions.ROTATE:
+                            l.calcPositionRotate(command.R, command.Mode);
+                            break;
+                        default:
+                            l.calcPositionCenter();
+                            break;
+                    }
+                }
+                TickEventSource.Log.end(TickEventSource.sections.PATH, start);
+
+                if (command.Direction != (byte)Controller.directions.POSE)
+                {
+                    start = TickEventSource.Log.begin();
+                    robot.body.calcGait(command.Mode == (byte)Controller.modes.TERRAIN);
+                    TickEventSource.Log.end(TickEventSource.sections.GAIT, start);
+                }
+            }
+        }
+
+        /**
+         * @class   PoseStage
+         *
+         * @brief   Balances the body with the accelerometer in balance mode, otherwise sets the pose of the command.
+         *          The body stays level during a transition.
+         */
+
+        private class PoseStage : ITickStage
+        {
+            /** @brief   The robot. */
+            Hexapod robot;
+
+            public PoseStage(Hexapod robot)
+            {
+                this.robot = robot;
+            }
+
+            public void run(TickCommand command)
+            {
+                if (robot.planner.Active)
+                {
+                    return;
+                }
+
+                if (command.Mode == (byte)Controller.modes.BALANCE)
+                {
+                    //get accelerometer data
+                    long start = TickEventSource.Log.begin();
+                    robot.accel.read();
+                    TickEventSource.Log.end(TickEventSource.sections.IMU, start);
+
+                    //change pitch and roll based on accelerometer data (only with a new reading)
+                    start = TickEventSource.Log.begin();
+                    robot.balancer.update(robot.accel);
+                    robot.pitch = robot.balancer.Pitch;
+                    robot.roll = robot.balancer.Roll;
+                    TickEventSource.Log.end(TickEventSource.sections.BALANCE, start);
+
+                    start = TickEventSource.Log.begin();
+                    robot.body.calcPose(0, robot.pitch, -robot.roll, 0, 0, 0);
+                    TickEventSource.Log.end(TickEventSource.sections.POSE, start);
+                }
+                else
+                {
+                    //reset pitch and roll
+                    robot.pitch = 0;
+                    robot.roll = 0;
+                    robot.balancer.reset();
+
+                    if (command.Direction == (byte)Controller.directions.POSE)
+                    {
+                        long start = TickEventSource.Log.begin();
+                        robot.body.calcPose(command.Yaw, command.Pitch, command.Roll, command.A, command.B, command.C);
+                        TickEventSource.Log.end(TickEventSource.sections.POSE, start);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @class   EncodeStage
+         *
+         * @brief   Writes the tcp coordinates to each leg (with ground sensing in terrain mode).
+         *          The legcontrollers receive them directly, the servo hat and the bus thread on the flush.
+         */
+
+        private class EncodeStage : ITickStage
+        {
+            /** @brief   The robot. */
+            Hexapod robot;
+
+            public EncodeStage(Hexapod robot)
+            {
+                this.robot = robot;
+            }
+
+            public void run(TickCommand command)
+            {
+                bool terrain = command.Mode == (byte)Controller.modes.TERRAIN && command.Direction != (byte)Controller.directions.POSE
+                    && !robot.planner.Active;
+
+                foreach (Leg l in robot.legs)
+                {
+                    if (terrain)
+                    {
+                        l.calcDataTerrain();
+                    }
+                    else
+                    {
+                        l.calcData();
+                    }
+                }
+            }
+        }
+
+        /**
+         * @class   TransmitStage
+         *
+         * @brief   Sends the data written to the legs.
+         */
+
+        private class TransmitStage : ITickStage
+        {
+            /** @brief   The robot. */
+            Hexapod robot;
+
+            public TransmitStage(Hexapod robot)
+            {
+                this.robot = robot;
+            }
+
+            public void run(TickCommand command)
+            {
+                robot.flush();
+            }
+        }
+
+        /**
+         * @class   FeedbackStage
+         *
+         * @brief   Adapts the body height to the ground in terrain mode. Every grounded leg is read once per tick,
+         *          the correction is calculated from this snapshot.
+         *          The sense commands of all legs were sent by the encode stage, so the legs search for the ground
+         *          at the same time. A legcontroller does not answer while it senses (every read is a failed
+         *          transfer on the bus), so the legs are polled once per pollInterval until all answered or the
+         *          deadline (half of the period) passed. Legs that are still sensing are left out of the correction
+         *          in this tick.
+         */
+
+        private class FeedbackStage : ITickStage
+        {
+            /** @brief   The robot. */
+            Hexapod robot;
+
+            /** @brief   The legs that were grounded in this tick. */
+            bool[] grounded;
+
+            /** @brief   The leg heights read in this tick. */
+            int[] heights;
+
+            /** @brief   The legs that answered in this tick. */
+            bool[] answered;
+
+            /** @brief   Never set, waits between the polls without spinning. */
+            ManualResetEvent pause = new ManualResetEvent(false);
+
+            /** @brief   The time between two polls in milliseconds. */
+            private const int pollInterval = 1;
+
+            public FeedbackStage(Hexapod robot)
+            {
+                this.robot = robot;
+                grounded = new bool[robot.legs.Length];
+                heights = new int[robot.legs.Length];
+                answered = new bool[robot.legs.Length];
+            }
+
+            public void run(TickCommand command)
+            {
+                if (command.Mode != (byte)Controller.modes.TERRAIN || command.Direction == (byte)Controller.directions.POSE
+                    || robot.planner.Active)
+                {
+                    return;
+                }
+
+                int a = 0; //number of legs
+                int sum = 0; //sum of all z-psoitions
+                int pending = 0; //grounded legs that did not answer yet
+                for (int i = 0; i < robot.legs.Length; i++)
+                {
+                    //if leg is grounded
+                    grounded[i] = robot.legs[i].ZPos == 0;
+                    answered[i] = false;
+                    if (grounded[i])
+                    {
+                        pending++;
+                    }
+                }
+
+                //poll the grounded legs until all answered or the deadline passed
+                long deadline = Stopwatch.GetTimestamp() + robot.Period * Stopwatch.Frequency / 2000000;
+                long interval = pollInterval * Stopwatch.Frequency / 1000;
+                while (pending > 0)
+                {
+                    for (int i = 0; i < robot.legs.Length; i++)
+                    {
+                        if (grounded[i] && !answered[i] && robot.legs[i].tryReadLegHeight(out heights[i]))
+                        {
+                            answered[i] = true;
+                            pending--;
+                            a++;
+                            sum += heights[i];
+                        }
+                    }
+
+                    if (pending == 0 || deadline - Stopwatch.GetTimestamp() < interval)
+                    {
+                        break;
+                    }
+                    pause.WaitOne(pollInterval);
+                }
+
+                //no leg on the ground -> nothing to adapt
+                if (a == 0)
+                {
+                    return;
+                }
+
+                //get average heigth difference
+                sum = sum / a;
+
+                //adapt tcp height
+                for (int i = 0; i < robot.legs.Length; i++)
+                {
+                    if (answered[i])
+                    {
+                        Leg l = robot.legs[i];
+                        l.ZPos = heights[i] - sum;
+                        l.calcData();
+                        l.ZPos = 0;
+                    }
+                }
+                robot.flush();
+            }
+        }
+
+        #region Objects
+        /** @brief   The accelerometer (or a simulation). */
+        IImu accel = null;
+
+        /** @brief   The actuators (legcontrollers, servo hat or simulation). */
+        IActuatorBackend backend = null;
+
+        /** @brief   The gait and pose of all legs. */
+        BodyKinematics body = new BodyKinematics(6);
+
+        /** @brief   The stages of a tick. */
+        TickPipeline pipeline = new TickPipeline();
+
+        /** @brief   The movement of the current tick. */
+        TickCommand command = new TickCommand();
+
+        /** @brief   Moves the legs to the center when the direction changes. */
+        TransitionPlanner planner = null;
+
+        /** @brief   Keeps the body level in balance mode. */
+        BalanceController balancer = new BalanceController();
+
+        /** @brief   Records every tick (null if off). */
+        FlightRecorder recorder = null;
+        #endregion Objects
+
+        #region Fields
+        /** @brief   The last direction. */
+        byte lastDirection = 100;
+
+        /** @brief   The pitch of the robot */
+        double pitch = 0.0;
+        /** @brief   The roll of the robot */
+        double roll = 0.0;
+
+        /** @brief   Width of the body in mm. */
+        const double bodyWidth = 200;
+
+        /** @brief   The body heigth in mm. */
+        const double bodyHeigth = 300;
+        #endregion Fields
+
+        #region Arrays
+        /** @brief   The legs. */
+        Leg[] legs = new Leg[6];
+        #endregion Arrays
+
+        #region Properties
+
+        /**
+         * @property    public TickPipeline Pipeline
+         *
+         * @brief   Gets the stages of a tick (replace a stage or read the time of each stage)
+         *
+         * @return  The pipeline.
+         */
+
+        public TickPipeline Pipeline
+        {
+            get { return pipeline; }
+        }
+
+        /**
+         * @property    public long Period
+         *
+         * @brief   Gets or sets the period of the ticks in microseconds (speed of the transitions)
+         *
+         * @return  The period.
+         */
+
+        public long Period { get; set; } = 25000;
+
+        /**
+         * @property    public long InputTimestamp
+         *
+         * @brief   Gets or sets the time of the input reading of the next movements (latency of the stages)
+         *
+         * @return  The timestamp (stopwatch ticks, 0 = unknown).
+         */
+
+        public long InputTimestamp { get; set; }
+
+        /**
+         * @property    public BalanceController Balance
+         *
+         * @brief   Gets the balance controller (gains and limit)
+         *
+         * @return  The balance controller.
+         */
+
+        public BalanceController Balance
+        {
+            get { return balancer; }
+        }
+
+        /**
+         * @property    public FlightRecorder Recorder
+         *
+         * @brief   Gets or sets the flight recorder (null = off, not while a tick runs)
+         *
+         * @return  The flight recorder.
+         */
+
+        public FlightRecorder Recorder
+        {
+            get { return recorder; }
+            set { recorder = value; }
+        }
+
+        #endregion Properties
+
+        #region Functions
+
+        /**
+         * @fn  public Hexapod()
+         *
+         * @brief   Default constructor, creates the stages of a tick
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public Hexapod()
+        {
+            pipeline.setStage(TickPipeline.stages.INPUT, new InputStage(this));
+            pipeline.setStage(TickPipeline.stages.GAIT, new GaitStage(this));
+            pipeline.setStage(TickPipeline.stages.POSE, new PoseStage(this));
+            pipeline.setStage(TickPipeline.stages.ENCODE, new EncodeStage(this));
+            pipeline.setStage(TickPipeline.stages.TRANSMIT, new TransmitStage(this));
+            pipeline.setStage(TickPipeline.stages.FEEDBACK, new FeedbackStage(this));
+
+            //the right front, left middle and right back leg move first
+            planner = new TransitionPlanner(body, new int[][] { new int[] { 1, 2, 5 }, new int[] { 0, 3, 4 } });
+        }
+
+
+        /**
+         * @fn  public void init(IActuatorBackend backend, IImu accel)
+         *
+         * @brief   Initializes this device
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         *
+         * @param   backend The actuators.
+         * @param   accel   The accelerometer.
+         */
+
+        public void init(IActuatorBackend backend, IImu accel)
+        {
+            /* Leg positions
+             *     ___
+             * 0 -|   |- 1
+             * 2 -|   |- 3
+             * 4 -|___|- 5
+             */
+
+            //giat offset,cal alpha,cal beta, cal gamma , rotation offset, bus (i2c address, position), x offset, y offset, body, position;
+
+            this.backend = backend;
+            this.accel = accel;
+
+            //left
+            legs[0] = new Leg(25, 10, -5, 2, 135, backend.open(0x11, 0), 150, 175, body, 0);
+            legs[2] = new Leg(75, 5, -2, 7, 180, backend.open(0x12, 2), 0, 175, body, 2);
+            legs[4] = new Leg(25, 3, -4, 3, 225, backend.open(0x13, 4), -150, 175, body, 4);
+
+            //right
+            legs[1] = new Leg(75, 0, -7, 0, 45, backend.open(0x21, 1), 150, -175, body, 1);
+            legs[3] = new Leg(25, 0, 0, -3, 0, backend.open(0x22, 3), 0, -175, body, 3);
+            legs[5] = new Leg(75, -7, 6, 3, 315, backend.open(0x23, 5), -150, -175, body, 5);
+
+            //the legcontrollers have their calibration in the eeprom, emulated legs need it at startup
+            if (!backend.Calibrated)
+            {
+                foreach (Leg l in legs)
+                {
+                    l.sendCalibrationData();
+                }
+            }
+
+
+
+
+        }
+
+
+
+        /**
+         * @fn  public void walk(double inc_x, double inc_y, byte mode)
+         *
+         * @brief   Walks
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         *
+         * @param   inc_x   The increment of the x coordinate.
+         * @param   inc_y   The increment of the y coordinate.
+         * @param   mode    The mode.
+         */
+
+        public void walk(double inc_x, double inc_y, byte mode)
+        {
+            command.Direction = (byte)Controller.directions.XY;
+            command.Mode = mode;
+            command.InputTimestamp = InputTimestamp;
+            command.X = inc_x;
+            command.Y = inc_y;
+            run();
+        }
+
+        /**
+         * @fn  public void turn(double inc_x, double inc_r, byte mode)
+         *
+         * @brief   Turns around a given point on the y axis
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         *
+         * @param   inc_x   The increment of the movement.
+         * @param   inc_r   Faktor of the radius.
+         * @param   mode    The mode.
+         */
+
+        public void turn(double inc_x, double inc_r, byte mode)
+        {
+            command.Direction = (byte)Controller.directions.TURN;
+            command.Mode = mode;
+            command.InputTimestamp = InputTimestamp;
+            command.X = inc_x;
+            command.R = inc_r;
+            run();
+        }
+
+        /**
+         * @fn  public void rotate(double inc_r, byte mode)
+         *
+         * @brief   Rotates around the center of the body
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         *
+         * @param   inc_r   The increment of the movement.
+         * @param   mode    The mode.
+         */
+
+        public void rotate(double inc_r, byte mode)
+        {
+            command.Direction = (byte)Controller.directions.ROTATE;
+            command.Mode = mode;
+            command.InputTimestamp = InputTimestamp;
+            command.R = inc_r;
+            run();
+        }
+
+        /**
+         * @fn  public void pose(double yaw, double pitch, double roll, double a, double b, double c)
+         *
+         * @brief   Changes the pose of the robot
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         *
+         * @param   yaw     The yaw.
+         * @param   pitch   The pitch.
+         * @param   roll    The roll.
+         * @param   a       Distance to move on x axis.
+         * @param   b       Distance to move on y axis.
+         * @param   c       Distance to move on z axis.
+         */
+
+        public void pose(double yaw, double pitch, double roll, double a, double b, double c, byte mode)
+        {
+            command.Direction = (byte)Controller.directions.POSE;
+            command.Mode = mode;
+            command.InputTimestamp = InputTimestamp;
+            command.Yaw = yaw;
+            command.Pitch = pitch;
+            command.Roll = roll;
+            command.A = a;
+            command.B = b;
+            command.C = c;
+            run();
+        }
+
+        /**
+         * @fn  private void run()
+         *
+         * @brief   Runs the stages for the command and records the tick
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        private void run()
+        {
+            pipeline.run(command);
+            if (recorder != null)
+            {
+                recorder.record(command, planner.Active, accel, balancer, body, legs, pipeline);
+            }
+        }
+
+        /**
+         * @fn  private void centerLegs()
+         *
+         * @brief   Starts moving all legs to the center (one tripod after the other, see TransitionPlanner).
+         *          The ticks continue while the legs move.
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         */
+
+        private void centerLegs()
+        {
+            pitch = 0;
+            roll = 0;
+            balancer.reset();
+
+            planner.start();
+        }
+
+        /**
+         * @fn  private void flush()
+         *
+         * @brief   Sends the data written to the legs since the last flush (servo hat: one i2c write).
+         *          The legcontrollers receive their positions directly in calcData().
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        private void flush()
+        {
+            backend.flush();
+        }
+
+        public void shutdown()
+        {
+            foreach (Leg item in legs)
+            {
+                item.setColor(300);
+            }
+        }
+
+        #endregion Functions
+    }
+}
@@ -0,0 +1,65 @@
+﻿/**********************************************************************************************//**
+ * @file    IActuatorBackend.cs
+ *
+ * @brief   Declares the IActuatorBackend interface.
+ **************************************************************************************************/
+
+namespace HexPi
+{
+
+    /**
+     * @interface   IActuatorBackend
+     *
+     * @brief   The actuators of the robot. Creates the bus of each leg and sends what was written during a tick.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    interface IActuatorBackend
+    {
+
+        /**
+         * @property    bool Calibrated
+         *
+         * @brief   Gets whether the legs keep their calibration themselves (eeprom of the legcontrollers).
+         *          Otherwise the calibration is sent at startup.
+         *
+         * @return  True if the legs are calibrated.
+         */
+
+        bool Calibrated { get; }
+
+        /**
+         * @property    long FramePeriod
+         *
+         * @brief   Gets the period of the servo signals. A new position takes effect with the next period,
+         *          frames sent faster only load the bus and the legcontrollers.
+         *
+         * @return  The period in microseconds (0 = no limit).
+         */
+
+        long FramePeriod { get; }
+
+        /**
+         * @fn  ILegBus open(byte address, int index);
+         *
+         * @brief   Opens the bus of a leg
+         *
+         * @param   address The i2c address of the legcontroller (0x1X = left, 0x2X = right).
+         * @param   index   The position of the leg (0 - 5).
+         *
+         * @return  The bus of the leg.
+         */
+
+        ILegBus open(byte address, int index);
+
+        /**
+         * @fn  void flush();
+         *
+         * @brief   Sends the data of all legs written since the last flush (called once per tick).
+         */
+
+        void flush();
+    }
+}
@@ -0,0 +1,91 @@
+﻿/**********************************************************************************************//**
+ * @file    IImu.cs
+ *
+ * @brief   Declares the IImu interface.
+ **************************************************************************************************/
+
+namespace HexPi
+{
+
+    /**
+     * @interface   IImu
+     *
+     * @brief   The inertial sensor of the robot (accelerometer on the pi or a simulation).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    interface IImu
+    {
+
+        /**
+         * @property    double Pitch
+         *
+         * @brief   Gets the pitch of the last reading
+         *
+         * @return  The pitch in rad.
+         */
+
+        double Pitch { get; }
+
+        /**
+         * @property    double Roll
+         *
+         * @brief   Gets the roll of the last reading
+         *
+         * @return  The roll in rad.
+         */
+
+        double Roll { get; }
+
+        /**
+         * @property    double PitchRate
+         *
+         * @brief   Gets the pitch rate of the last reading
+         *
+         * @return  The pitch rate in rad/s.
+         */
+
+        double PitchRate { get; }
+
+        /**
+         * @property    double RollRate
+         *
+         * @brief   Gets the roll rate of the last reading
+         *
+         * @return  The roll rate in rad/s.
+         */
+
+        double RollRate { get; }
+
+        /**
+         * @property    long Timestamp
+         *
+         * @brief   Gets the time of the measurement of the last reading
+         *
+         * @return  The timestamp (stopwatch ticks).
+         */
+
+        long Timestamp { get; }
+
+        /**
+         * @fn  long takeBusTime();
+         *
+         * @brief   Gets the time the sensor spent on the bus since the last call (reads outside of read(),
+         *          e.g. by a sampler thread)
+         *
+         * @return  The bus time in stopwatch ticks.
+         */
+
+        long takeBusTime();
+
+        /**
+         * @fn  void read();
+         *
+         * @brief   Reads new data from the sensor.
+         */
+
+        void read();
+    }
+}
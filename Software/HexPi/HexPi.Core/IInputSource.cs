@@ -0,0 +1,34 @@
+﻿/**********************************************************************************************//**
+ * @file    IInputSource.cs
+ *
+ * @brief   Declares the IInputSource interface.
+ **************************************************************************************************/
+
+namespace HexPi
+{
+
+    /**
+     * @interface   IInputSource
+     *
+     * @brief   The input device of the robot (gamepad or a simulation).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    interface IInputSource
+    {
+
+        /**
+         * @fn  bool read(out InputState state);
+         *
+         * @brief   Gets the current reading of the input device
+         *
+         * @param [out] state   The reading.
+         *
+         * @return  False if no input device is connected.
+         */
+
+        bool read(out InputState state);
+    }
+}
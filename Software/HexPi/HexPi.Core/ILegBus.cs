@@ -0,0 +1,48 @@
+﻿/**********************************************************************************************//**
+ * @file    ILegBus.cs
+ *
+ * @brief   Declares the ILegBus interface.
+ **************************************************************************************************/
+
+namespace HexPi
+{
+
+    /**
+     * @interface   ILegBus
+     *
+     * @brief   The connection of a leg to its legcontroller.
+     *          Frames use the legcontroller protocol (first byte = command).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    interface ILegBus
+    {
+
+        /**
+         * @fn  bool write(byte[] data);
+         *
+         * @brief   Writes a frame to the legcontroller. The caller reuses the frame after the call,
+         *          a bus that sends later has to copy it.
+         *
+         * @param   data    The frame (command and parameters).
+         *
+         * @return  False if the legcontroller did not acknowledge the frame (a queued frame counts as sent).
+         */
+
+        bool write(byte[] data);
+
+        /**
+         * @fn  bool read(byte[] data);
+         *
+         * @brief   Reads from the legcontroller (current z position of the TCP)
+         *
+         * @param   data    The buffer.
+         *
+         * @return  True if the buffer was filled.
+         */
+
+        bool read(byte[] data);
+    }
+}
@@ -0,0 +1,48 @@
+﻿/**********************************************************************************************//**
+ * @file    IMetricsListener.cs
+ *
+ * @brief   Declares the IMetricsListener interface.
+ **************************************************************************************************/
+
+using System;
+using System.IO;
+
+namespace HexPi
+{
+
+    /**
+     * @interface   IMetricsListener
+     *
+     * @brief   Accepts the connections of the metrics endpoint on localhost
+     *          (TcpListener on .NET Core, StreamSocketListener in the UWP app).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    interface IMetricsListener
+    {
+
+        /**
+         * @fn  int start(int port, Action<Stream, Stream> connected);
+         *
+         * @brief   Starts listening. Each connection is passed to connected with its input and output stream,
+         *          one at a time and never on the control thread, and closed when it returns.
+         *
+         * @param   port        The port (0 = any free port).
+         * @param   connected   Answers a connection (input, output).
+         *
+         * @return  The port (the chosen one if started with 0).
+         */
+
+        int start(int port, Action<Stream, Stream> connected);
+
+        /**
+         * @fn  void stop();
+         *
+         * @brief   Stops listening and waits for the connection being answered
+         */
+
+        void stop();
+    }
+}
@@ -0,0 +1,32 @@
+﻿/**********************************************************************************************//**
+ * @file    ITickStage.cs
+ *
+ * @brief   Declares the ITickStage interface.
+ **************************************************************************************************/
+
+namespace HexPi
+{
+
+    /**
+     * @interface   ITickStage
+     *
+     * @brief   A stage of the tick pipeline (see TickPipeline.stages).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    interface ITickStage
+    {
+
+        /**
+         * @fn  void run(TickCommand command);
+         *
+         * @brief   Runs the stage for one tick
+         *
+         * @param   command The movement of the tick.
+         */
+
+        void run(TickCommand command);
+    }
+}
@@ -0,0 +1,32 @@
+﻿/**********************************************************************************************//**
+ * @file    ImuSample.cs
+ *
+ * @brief   Implements the imu sample structure.
+ **************************************************************************************************/
+
+namespace HexPi
+{
+
+    /**
+     * @struct  ImuSample
+     *
+     * @brief   A filtered attitude of the inertial sensor.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    struct ImuSample
+    {
+        /** @brief   The time of the last measurement in the sample (stopwatch ticks). */
+        public long Timestamp;
+        /** @brief   The pitch in rad. */
+        public double Pitch;
+        /** @brief   The roll in rad. */
+        public double Roll;
+        /** @brief   The pitch rate in rad/s. */
+        public double PitchRate;
+        /** @brief   The roll rate in rad/s. */
+        public double RollRate;
+    }
+}
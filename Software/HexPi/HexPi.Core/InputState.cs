@@ -0,0 +1,39 @@
+﻿/**********************************************************************************************//**
+ * @file    InputState.cs
+ *
+ * @brief   Implements the input state structure.
+ **************************************************************************************************/
+
+namespace HexPi
+{
+
+    /**
+     * @struct  InputState
+     *
+     * @brief   One reading of the input device (axes -1 - 1, triggers 0 - 1).
+     *          A reading is copied as a whole, the sources publish it through a SampleSlot.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    struct InputState
+    {
+        /** @brief   The time of the reading (stopwatch ticks). */
+        public long Timestamp;
+        /** @brief   The x-axis of the left thumbstick. */
+        public double LeftThumbstickX;
+        /** @brief   The y-axis of the left thumbstick. */
+        public double LeftThumbstickY;
+        /** @brief   The x-axis of the right thumbstick. */
+        public double RightThumbstickX;
+        /** @brief   The y-axis of the right thumbstick. */
+        public double RightThumbstickY;
+        /** @brief   The left trigger. */
+        public double LeftTrigger;
+        /** @brief   The right trigger. */
+        public double RightTrigger;
+        /** @brief   The pressed buttons. */
+        public Controller.buttons Buttons;
+    }
+}
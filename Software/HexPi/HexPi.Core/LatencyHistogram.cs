@@ -0,0 +1,230 @@
+﻿/**********************************************************************************************//**
+ * @file    LatencyHistogram.cs
+ *
+ * @brief   Implements the latency histogram class.
+ **************************************************************************************************/
+
+using System;
+
+namespace HexPi
+{
+
+    /**
+     * @class   LatencyHistogram
+     *
+     * @brief   Counts latencies in microseconds without allocating. Below 16us each microsecond has its own bucket,
+     *          above every power of two is split into 8 buckets, so a percentile is at most 12.5% too high.
+     *          Not thread safe (the owner locks).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class LatencyHistogram
+    {
+
+        /**
+         * @struct  Summary
+         *
+         * @brief   The percentiles of a histogram (times in microseconds).
+         */
+
+        public struct Summary
+        {
+            /** @brief   The number of latencies. */
+            public long Count;
+            /** @brief   The median. */
+            public double P50;
+            /** @brief   The 99th percentile. */
+            public double P99;
+            /** @brief   The maximum. */
+            public double Max;
+        }
+
+        #region FIELDS
+        /** @brief   The number of latencies. */
+        private long count = 0;
+
+        /** @brief   The maximum latency in microseconds. */
+        private long max = 0;
+        #endregion FIELDS
+
+        #region CONSTANTS
+        /** @brief   The number of buckets with a width of 1us. */
+        private const int linear = 16;
+
+        /** @brief   The buckets per power of two (log2). */
+        private const int subBits = 3;
+
+        /** @brief   The highest power of two (latencies above 2^40us are counted in the last bucket). */
+        private const int maxExponent = 40;
+        #endregion CONSTANTS
+
+        #region Arrays
+        /** @brief   The number of latencies in each bucket. */
+        private long[] buckets = new long[linear + (maxExponent - 3) * (1 << subBits)];
+        #endregion Arrays
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public void add(long us)
+         *
+         * @brief   Adds a latency
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   us  The latency in microseconds.
+         */
+
+        public void add(long us)
+        {
+            if (us < 0)
+            {
+                us = 0;
+            }
+            buckets[Math.Min(bucket(us), buckets.Length - 1)]++;
+            count++;
+            if (us > max)
+            {
+                max = us;
+            }
+        }
+
+
+
+        /**
+         * @fn  public Summary getSummary()
+         *
+         * @brief   Gets the percentiles
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The summary (empty without latencies).
+         */
+
+        public Summary getSummary()
+        {
+            Summary s = new Summary();
+            s.Count = count;
+            if (count > 0)
+            {
+                s.P50 = percentile(0.5);
+                s.P99 = percentile(0.99);
+                s.Max = max;
+            }
+            return s;
+        }
+
+
+
+        /**
+         * @fn  public void reset()
+         *
+         * @brief   Removes all latencies
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void reset()
+        {
+            Array.Clear(buckets, 0, buckets.Length);
+            count = 0;
+            max = 0;
+        }
+
+
+
+        /**
+         * @fn  private double percentile(double p)
+         *
+         * @brief   Gets the upper bound of the bucket that holds a percentile (never above the maximum)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   p   The percentile (0 - 1).
+         *
+         * @return  The latency in microseconds.
+         */
+
+        private double percentile(double p)
+        {
+            long rank = (long)Math.Ceiling(p * count);
+            long sum = 0;
+            for (int i = 0; i < buckets.Length; i++)
+            {
+                sum += buckets[i];
+                if (sum >= rank)
+                {
+                    return Math.Min(upperBound(i), max);
+                }
+            }
+            return max;
+        }
+
+
+
+        /**
+         * @fn  private static int bucket(long us)
+         *
+         * @brief   Gets the bucket of a latency
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   us  The latency in microseconds.
+         *
+         * @return  The index of the bucket.
+         */
+
+        private static int bucket(long us)
+        {
+            if (us < linear)
+            {
+                return (int)us;
+            }
+
+            int exponent = 0;
+            for (long v = us; v > 1; v >>= 1)
+            {
+                exponent++;
+            }
+            int sub = (int)(us >> (exponent - subBits)) & ((1 << subBits) - 1);
+            return linear + (exponent - 4) * (1 << subBits) + sub;
+        }
+
+
+
+        /**
+         * @fn  private static long upperBound(int index)
+         *
+         * @brief   Gets the highest latency of a bucket
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   index   The index of the bucket.
+         *
+         * @return  The latency in microseconds.
+         */
+
+        private static long upperBound(int index)
+        {
+            if (index < linear)
+            {
+                return index;
+            }
+
+            int exponent = (index - linear) / (1 << subBits) + 4;
+            int sub = (index - linear) % (1 << subBits);
+            long width = 1L << (exponent - subBits);
+            return ((1 << subBits) + sub) * width + width - 1;
+        }
+
+        #endregion FUNCTIONS
+    }
+}
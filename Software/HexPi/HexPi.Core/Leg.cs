@@ -10,8 +10,6 @@ using System.Diagnostics;
 using System.Linq;
 using System.Text;
 using System.Threading.Tasks;
-using Windows.Devices.Enumeration;
-using Windows.Devices.I2c;
 
 namespace HexPi
 {
@@ -28,8 +26,11 @@ namespace HexPi
     class Leg
     {
         #region Objects
-        /** @brief   The i2c-device. */
-        I2cDevice device = null;
+        /** @brief   The bus to the legcontroller. */
+        ILegBus bus = null;
+
+        /** @brief   The gait and pose of all legs (holds the state of this leg). */
+        BodyKinematics body = null;
 
         #endregion Objects
 
@@ -47,20 +48,11 @@ namespace HexPi
         /** @brief   The offset of the third angle. */
         private double gammaOff = 0;
 
-        /** @brief   The control variable of the calculations. */
-        private double t = 0;
-
         /** @brief   The offset for the control variable. */
         private double tOffset = 0;
 
-        /** @brief   The x position of the TCP. */
-        private double xPos = 0;
-
-        /** @brief   The y position of the TCP. */
-        private double yPos = 0;
-
-        /** @brief   The z position of the TCP. */
-        private double zPos = 0;
+        /** @brief   The index of the leg in the body. */
+        private int index = 0;
 
         /** @brief   The leg-position x-offset */
         private double xOffset = 0;
@@ -74,8 +66,8 @@ namespace HexPi
         /** @brief   The rotation of the movement line at xy-movement. */
         private double xyRotation = 0;
 
-        /** @brief   The i2c identifier */
-        private byte id = 0;
+        /** @brief   The rotation of the path in the body (cosine and sine are only calculated when it changes). */
+        private double pathRotation = double.NaN;
 
 
         #endregion FIELDS
@@ -83,24 +75,17 @@ namespace HexPi
         #region CONSTANTS
 
         /** @brief   The step size for z coordinate in mm. */
-        private const double stepSizeZ = 40;
+        private const double stepSizeZ = BodyKinematics.stepSizeZ;
 
         /** @brief   The step size for rotation in mm. */
-        private const double stepSizeXY = 30;
+        private const double stepSizeXY = BodyKinematics.stepSizeXY;
 
         /** @brief   The period. */
-        private const int period = 100;
+        private const int period = BodyKinematics.period;
 
-        /** @brief   The section to lift the leg in terrain mode */
-        private const int lift = period / 2 + 10;
-        /** @brief   The section to sense the ground in terrain mode */
-        private const int sense = period / 2 + 40;
         /** @brief   The frame around 0/0/0 to change the rotation angle */
         private const int frame = 1;
 
-        /** @brief   The height of the first joint. */
-        private const double zOffset = 88;
-
         /** @brief   The distance between the first and second joint in mm. */
         private const double A1 = 52;
 
@@ -113,8 +98,49 @@ namespace HexPi
 
         #endregion CONSTANTS
 
+        #region Arrays
+
+        /** @brief   The frame to set the tcp position (reused, the bus copies or sends it before write returns). */
+        private byte[] positionFrame = new byte[4];
+
+        /** @brief   The frame to set the led color. */
+        private byte[] colorFrame = new byte[3];
+
+        /** @brief   The buffer for the leg height. */
+        private byte[] heightBuffer = new byte[1];
+
+        #endregion Arrays
+
         #region PROPERTIES
 
+        /** @brief   The control variable of the calculations (stored in the body). */
+        private double t
+        {
+            get { return body.T[index]; }
+            set { body.T[index] = value; }
+        }
+
+        /** @brief   The x position of the TCP (stored in the body). */
+        private double xPos
+        {
+            get { return body.X[index]; }
+            set { body.X[index] = value; }
+        }
+
+        /** @brief   The y position of the TCP (stored in the body). */
+        private double yPos
+        {
+            get { return body.Y[index]; }
+            set { body.Y[index] = value; }
+        }
+
+        /** @brief   The z position of the TCP (stored in the body). */
+        private double zPos
+        {
+            get { return body.Z[index]; }
+            set { body.Z[index] = value; }
+        }
+
 
         /**
          * @property    public int XPos
@@ -240,6 +266,45 @@ namespace HexPi
 
 
 
+        /**
+         * @property    public int Height
+         *
+         * @brief   Gets the last leg height read from the legcontroller
+         *
+         * @return  The leg height in mm.
+         */
+
+        public int Height { get; private set; }
+
+
+
+        /**
+         * @property    public long HeightTimestamp
+         *
+         * @brief   Gets the time of the last leg height read
+         *
+         * @return  The time (stopwatch ticks, 0 = never read).
+         */
+
+        public long HeightTimestamp { get; private set; }
+
+
+
+        /**
+         * @property    public byte[] PositionFrame
+         *
+         * @brief   Gets the last frame to set the tcp position (do not change)
+         *
+         * @return  The frame (command, x, y, z).
+         */
+
+        public byte[] PositionFrame
+        {
+            get { return positionFrame; }
+        }
+
+
+
         #endregion PROPERTIES
 
         #region FUNCTIONS
@@ -248,7 +313,7 @@ namespace HexPi
 
 
         /**
-         * @fn  public Leg(int tOffset, int aOff, int bOff, int cOff, double rotation, byte address, int xOff, int yOff)
+         * @fn  public Leg(int tOffset, int aOff, int bOff, int cOff, double rotation, ILegBus bus, int xOff, int yOff, BodyKinematics body, int index)
          *
          * @brief   Constructor
          *
@@ -260,13 +325,18 @@ namespace HexPi
          * @param   bOff        The offset for beta.
          * @param   cOff        The offset for gamma.
          * @param   rotation    The angle of the leg path in rotation.
-         * @param   address     The i2c address.
+         * @param   bus         The bus to the legcontroller.
          * @param   xOff        The x offset from the center of the body.
          * @param   yOff        The y offset from the center of the body.
+         * @param   body        The gait and pose of all legs.
+         * @param   index       The index of the leg in the body.
          */
 
-        public Leg(int tOffset, int aOff, int bOff, int cOff, double rotation, byte address, int xOff, int yOff)
+        public Leg(int tOffset, int aOff, int bOff, int cOff, double rotation, ILegBus bus, int xOff, int yOff, BodyKinematics body, int index)
         {
+            this.body = body;
+            this.index = index;
+
             this.tOffset = tOffset;
             t = this.tOffset;
 
@@ -276,11 +346,13 @@ namespace HexPi
 
             xOffset = xOff;
             yOffset = yOff;
+            body.XOffset[index] = xOff;
+            body.YOffset[index] = yOff;
 
 
             this.rRotation = (rotation / 180) * Math.PI;
 
-            init(address);
+            this.bus = bus;
 
 
 
@@ -289,37 +361,6 @@ namespace HexPi
 
 
 
-        /**
-         * @fn  public async void init(byte address)
-         *
-         * @brief   Initializes this device
-         *
-         * @author  Alexander Miller
-         * @date    13.08.2017
-         *
-         * @param   address The i2c address.
-         */
-
-        public async void init(byte address)
-        {
-            try
-            {
-                id = address;
-                I2cConnectionSettings settings = new I2cConnectionSettings(address); // Address
-                settings.BusSpeed = I2cBusSpeed.FastMode;
-                settings.SharingMode = I2cSharingMode.Shared;
-                string aqs = I2cDevice.GetDeviceSelector("I2C1");
-                DeviceInformationCollection dis = await DeviceInformation.FindAllAsync(aqs);
-                device = await I2cDevice.FromIdAsync(dis[0].Id, settings);
-            }
-            catch
-            {
-                Debug.WriteLine("Error: I2C init failed!");
-            }
-        }
-
-
-
         /**
          * @fn  public void calcPositionRotate(double increment, byte mode)
          *
@@ -334,6 +375,8 @@ namespace HexPi
 
         public void calcPositionRotate(double increment, byte mode)
         {
+            double lastT = t;
+
             //if in terrain mode-> walk slower
             if (mode == (byte)Controller.modes.TERRAIN)
             {
@@ -344,7 +387,7 @@ namespace HexPi
                 t = ((t + Math.Abs(increment)) + period) % period;
             }
 
-            if ((t >= period * 0.75 - frame) && (t <= period * 0.75 + frame) || (t >= period * 0.25 - frame) && (t <= period * 0.25 + frame))
+            if (isTurningPoint(lastT))
             {
                 if (increment >= 0)
                 {
@@ -359,7 +402,7 @@ namespace HexPi
 
 
             //calc tcp xy position based on rRotation 
-            calcXY(stepSizeXY, xyRotation, mode);
+            setPath(stepSizeXY, xyRotation);
         }
 
         /**
@@ -379,11 +422,12 @@ namespace HexPi
         {
             a = -a;
 
+            double lastT = t;
             t = ((t + Math.Abs(x)) + period) % period;
 
 
-            //if t is equal to period*0.25 or period*0.75 +- frame
-            if ((t >= period * 0.75 - frame) && (t <= period * 0.75 + frame) || (t >= period * 0.25 - frame) && (t <= period * 0.25 + frame))
+            //if t is equal to period*0.25 or period*0.75 +- frame (or passed it)
+            if (isTurningPoint(lastT))
             {
 
                 //calc the radius of the circle
@@ -464,7 +508,7 @@ namespace HexPi
 
             }
             //calc tcp position based on calculatet angle and stepsize
-            calcXY(stepSizeTurn, xyRotation, mode);
+            setPath(stepSizeTurn, xyRotation);
         }
 
 
@@ -484,7 +528,7 @@ namespace HexPi
         public void calcPositionWalk(double x, double y, byte mode)
         {
 
-
+            double lastT = t;
 
             //if in terrain mode-> walk slower
             if (mode == (byte)Controller.modes.TERRAIN)
@@ -497,198 +541,109 @@ namespace HexPi
             }
             //Debug.WriteLine(Math.Sqrt(x * x + y * y));
 
-            //if t is equal to period*0.25 or period*0.75 +- frame
-            if ((t >= period * 0.75 - frame) && (t <= period * 0.75 + frame) || (t >= period * 0.25 - frame) && (t <= period * 0.25 + frame))
+            //if t is equal to period*0.25 or period*0.75 +- frame (or passed it)
+            if (isTurningPoint(lastT))
             {
                 //calc angle based on the inputs
                 xyRotation = Math.Atan2(y, x);
             }
             //calc tcp position
-            calcXY(stepSizeXY, xyRotation, mode);
+            setPath(stepSizeXY, xyRotation);
 
 
         }
 
 
         /**
-         * @fn  public void calcPositionCenter()
+         * @fn  private bool isTurningPoint(double lastT)
          *
-         * @brief   Resets the TCP position and the control variable.
+         * @brief   Checks if the control variable is at period*0.25 or period*0.75 (+- frame) or passed one of them
+         *          since the last step (large increments at low tick rates)
          *
          * @author  Alexander Miller
-         * @date    13.08.2017
+         * @date    19.10.2026
+         *
+         * @param   lastT   The control variable before the step.
+         *
+         * @return  True if the direction of the movement may change.
          */
 
-        public void calcPositionCenter()
+        private bool isTurningPoint(double lastT)
         {
-            t = tOffset;
-            xPos = 0.0;
-            yPos = 0.0;
-            zPos = 0.0;
+            if ((t >= period * 0.75 - frame) && (t <= period * 0.75 + frame) || (t >= period * 0.25 - frame) && (t <= period * 0.25 + frame))
+            {
+                return true;
+            }
+
+            return passed(lastT, period * 0.25) || passed(lastT, period * 0.75);
         }
 
 
         /**
-         * @fn  public void calcXY(double stepsize, double rotation, byte mode)
+         * @fn  private bool passed(double lastT, double point)
          *
-         * @brief    Calculates the TCP position for movement in xy direction.
+         * @brief   Checks if the control variable passed a point since the last step
          *
          * @author  Alexander Miller
-         * @date    13.08.2017
+         * @date    19.10.2026
          *
-         * @param   stepsize    The stepsize.
-         * @param   rotation    The rotation.
-         * @param   mode        The mode.
+         * @param   lastT   The control variable before the step.
+         * @param   point   The point.
+         *
+         * @return  True if the point was passed.
          */
 
-        public void calcXY(double stepsize, double rotation, byte mode)
+        private bool passed(double lastT, double point)
         {
-
-            if (mode == (byte)Controller.modes.TERRAIN)
-            {
-
-                if (t <= period / 2)
-                {
-
-                    xPos = -4 * ((stepsize * Math.Cos(rotation)) / period) * t + (stepsize * Math.Cos(rotation));
-                    yPos = -4 * ((stepsize * Math.Sin(rotation)) / period) * t + (stepsize * Math.Sin(rotation));
-                }
-                else if (t > period / 2 && t <= lift)
-                {
-                    xPos = -stepsize * Math.Cos(rotation);
-                    yPos = -stepsize * Math.Sin(rotation);
-                }
-                else if (t > lift && t <= sense)
-                {
-                    xPos = 2 * ((stepsize * Math.Cos(rotation)) / (sense - lift)) * (t - lift) - (stepsize * Math.Cos(rotation));
-                    yPos = 2 * ((stepsize * Math.Sin(rotation)) / (sense - lift)) * (t - lift) - (stepsize * Math.Sin(rotation));
-                }
-                else if (t > sense)
-                {
-                    xPos = stepsize * Math.Cos(rotation);
-                    yPos = stepsize * Math.Sin(rotation);
-
-                }
-
-            }
-            else
-            {
-
-                if (t <= period / 2)
-                {
-                    xPos = -4 * ((stepsize * Math.Cos(rotation)) / period) * t + (stepsize * Math.Cos(rotation));
-                    yPos = -4 * ((stepsize * Math.Sin(rotation)) / period) * t + (stepsize * Math.Sin(rotation));
-                }
-                else
-                {
-                    xPos = 4 * ((stepsize * Math.Cos(rotation)) / period) * (t - period / 2) - (stepsize * Math.Cos(rotation));
-                    yPos = 4 * ((stepsize * Math.Sin(rotation)) / period) * (t - period / 2) - (stepsize * Math.Sin(rotation));
-                }
-
-            }
-            calcZ(mode);
-
-
-
-            //check boundaries
-            if (xPos > stepSizeXY)
-            {
-                xPos = stepSizeXY;
-            }
-            else if (xPos < -stepSizeXY)
-            {
-                xPos = -stepSizeXY;
-            }
-            if (yPos > stepSizeXY)
-            {
-                yPos = stepSizeXY;
-            }
-            else if (yPos < -stepSizeXY)
+            if (lastT <= t)
             {
-                yPos = -stepSizeXY;
+                return lastT < point && point <= t;
             }
-
-
-
+            //wrap around
+            return lastT < point || point <= t;
         }
 
+
         /**
-         * @fn  private void calcZ(byte mode)
+         * @fn  public void calcPositionCenter()
          *
-         * @brief   Calculates the z-position of the tcp
+         * @brief   Resets the TCP position and the control variable.
          *
          * @author  Alexander Miller
          * @date    13.08.2017
-         *
-         * @param   mode    The mode.
          */
 
-        private void calcZ(byte mode)
+        public void calcPositionCenter()
         {
-
-            if (mode == (byte)Controller.modes.TERRAIN)
-            {
-                if (t <= period / 2)
-                {
-
-                    zPos = 0;
-
-                }
-
-                else if (t > period / 2 && t <= lift)
-                {
-                    zPos = stepSizeZ;
-                }
-                else if (t > lift && t <= sense)
-                {
-                    zPos = stepSizeZ;
-                }
-                else if (t > sense)
-                {
-                    zPos = 0;
-                }
-            }
-            else
-            {
-                if (t <= period / 2)
-                {
-                    zPos = 0;
-
-                }
-                else if (t <= period * 0.6)
-                {
-                    zPos = -1 * (stepSizeZ * 100 / (period * period)) * (t - 0.6 * period) * (t - 0.6 * period) + stepSizeZ;
-                }
-                else if (t <= period)
-                {
-                    zPos = -1 * (stepSizeZ * 6.25 / (period * period)) * (t - 0.6 * period) * (t - 0.6 * period) + stepSizeZ;
-                }
-                //else if (t <= 3 * period / 4)
-                //{
-                //    zPos = -1 * (stepSizeZ * 16 / (period * period)) * (t - 3 * period / 4) * (t - 3 * period / 4) + stepSizeZ;
-                //}
-                //else if (t <= period)
-                //{
-                //    zPos = (stepSizeZ * 16 / (period * period)) * (t - period) * (t - period);
-                //}
-                else
-                {
-                    zPos = 0;
-                }
-
-            }
-
+            t = tOffset;
+            xPos = 0.0;
+            yPos = 0.0;
+            zPos = 0.0;
+        }
 
 
+        /**
+         * @fn  public void setPath(double stepsize, double rotation)
+         *
+         * @brief   Sets the path of the TCP for movement in xy direction (the positions are calculated by the body).
+         *          The direction only changes at the turning points, so cosine and sine are kept until then.
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   stepsize    The stepsize.
+         * @param   rotation    The rotation.
+         */
 
+        public void setPath(double stepsize, double rotation)
+        {
+            body.Step[index] = stepsize;
 
-            if (zPos > stepSizeZ)
-            {
-                zPos = stepSizeZ;
-            }
-            else if (zPos < -stepSizeZ)
+            if (rotation != pathRotation)
             {
-                zPos = -stepSizeZ;
+                pathRotation = rotation;
+                body.Cos[index] = Math.Cos(rotation);
+                body.Sin[index] = Math.Sin(rotation);
             }
         }
 
@@ -708,19 +663,15 @@ namespace HexPi
 
         public void calcData()
         {
-
-
-
-            byte[] data = new byte[4];
             //set tcp position command
-            data[0] = 3;
+            positionFrame[0] = 3;
             //tcp position
-            data[1] = (Byte)XPos;
-            data[2] = (Byte)YPos;
-            data[3] = (Byte)ZPos;
+            positionFrame[1] = (Byte)XPos;
+            positionFrame[2] = (Byte)YPos;
+            positionFrame[3] = (Byte)ZPos;
 
             //send data over i2c
-            sendData(data);
+            sendData(positionFrame);
 
         }
 
@@ -736,13 +687,12 @@ namespace HexPi
         public void calcDataTerrain()
         {
 
-            byte[] data = new byte[4];
             //set tcp position with ground sensing
-            data[0] = 6;
-            data[1] = (Byte)XPos;
-            data[2] = (Byte)YPos;
-            data[3] = (Byte)ZPos;
-            sendData(data);
+            positionFrame[0] = 6;
+            positionFrame[1] = (Byte)XPos;
+            positionFrame[2] = (Byte)YPos;
+            positionFrame[3] = (Byte)ZPos;
+            sendData(positionFrame);
         }
 
         /**
@@ -758,15 +708,13 @@ namespace HexPi
 
         public void setColor(ushort hue)
         {
-            byte[] byteArray = BitConverter.GetBytes(hue);
-
-            byte[] data = new byte[3];
             //set led color command
-            data[0] = 1;
-            data[1] = byteArray[1];
-            data[2] = byteArray[0];
+            colorFrame[0] = 1;
+            //hue (big endian)
+            colorFrame[1] = (byte)(hue >> 8);
+            colorFrame[2] = (byte)hue;
 
-            sendData(data);
+            sendData(colorFrame);
         }
 
 
@@ -774,7 +722,7 @@ namespace HexPi
         /**
          * @fn  public void sendData(byte[] data)
          *
-         * @brief   Sends a data array over i2c
+         * @brief   Sends a data array to the legcontroller
          *
          * @author  Alexander Miller
          * @date    13.08.2017
@@ -784,23 +732,7 @@ namespace HexPi
 
         public void sendData(byte[] data)
         {
-            try
-            {
-                if (device != null)
-                {
-                    device.Write(data);
-                }
-                else
-                {
-                    //Debug.WriteLine("Error: I2C write failed!");
-                }
-
-            }
-            catch (Exception e)
-            {
-                Debug.WriteLine("Error: I2C hat write failed!" + e.Message);
-            }
-
+            bus.write(data);
         }
 
         /**
@@ -838,73 +770,37 @@ namespace HexPi
 
         public int readLegHeight()
         {
-            try
-            {
-                byte[] height = new byte[1];
-                if (device != null)
-                {
-                    //read 1 byte
-                    device.Read(height);
-                    //return leg hight (signed byte!)
-                    return (sbyte)height[0];
-                }
-                else
-                {
-                    //Debug.WriteLine("Error: I2C write failed!");
-                    return 0;
-                }
-
-            }
-            catch (Exception e)
-            {
-                Debug.WriteLine("Error: I2C hat read failed!" + e.Message);
-            }
-            return 0;
+            int height;
+            tryReadLegHeight(out height);
+            return height;
         }
 
         /**
-         * @fn  public void calcPose(double yaw, double pitch, double roll, double a, double b, double c)
+         * @fn  public bool tryReadLegHeight(out int height)
          *
-         * @brief   Calculates the pose
+         * @brief   Reads leg height. Fails while the legcontroller senses the ground (it does not answer then).
          *
          * @author  Alexander Miller
-         * @date    13.08.2017
+         * @date    19.10.2026
+         *
+         * @param [out] height  The leg height in mm (0 if the read failed).
          *
-         * @param   yaw     The yaw.
-         * @param   pitch   The pitch.
-         * @param   roll    The roll.
-         * @param   a       Distance to move along the x axis.
-         * @param   b       Distance to move along the y axis.
-         * @param   c       Distance to move along the z axis.
+         * @return  True if the height was read.
          */
 
-        public void calcPose(double yaw, double pitch, double roll, double a, double b, double c)
+        public bool tryReadLegHeight(out int height)
         {
-
-            //TCP coordinate in global coordinate system ( 0/0/0 = center of body ; +x = front; +z = top ; +y = left)
-            double tempX = xOffset - xPos;
-            double tempY = yOffset - yPos;
-            double tempZ = zOffset - zPos;
-            double sA = Math.Sin(yaw);
-            double sB = Math.Sin(pitch);
-            double sC = Math.Sin(roll);
-            double cA = Math.Cos(yaw);
-            double cB = Math.Cos(pitch);
-            double cC = Math.Cos(roll);
-
-
-
-
-            //Roll-Pitch-Yaw-Rotation matrix
-            double newX = tempX * (cA * cB) + tempY * (cA * sB * sC - sA * cC) + tempZ * (sA * sC + cA * sB * cC);
-            double newY = tempX * (sA * cB) + tempY * (cA * cC + sA * sB * sC) + tempZ * (sA * sB * cC - cA * sC);
-            double newZ = tempX * (-sB) + tempY * (cB * sC) + tempZ * (cB * cC);
-
-            //Set leg position in local coordinate system
-            xPos += newX - tempX + a;
-            yPos += newY - tempY + b;
-            zPos += newZ - tempZ + c;
-
+            //read 1 byte
+            if (bus.read(heightBuffer))
+            {
+                //return leg hight (signed byte!)
+                Height = (sbyte)heightBuffer[0];
+                HeightTimestamp = Stopwatch.GetTimestamp();
+                height = Height;
+                return true;
+            }
+            height = 0;
+            return false;
         }
 
         #endregion FUNCTIONS
@@ -0,0 +1,341 @@
+﻿/**********************************************************************************************//**
+ * @file    LegEmulator.cs
+ *
+ * @brief   Implements the leg emulator class.
+ **************************************************************************************************/
+
+using System;
+
+namespace HexPi
+{
+
+    /**
+     * @class   LegEmulator
+     *
+     * @brief   Runs the legcontroller firmware on the pi (commands, inverse kinematics, calibration and ground sensing).
+     *          Derived classes decide what happens with the calculated servo angles.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    abstract class LegEmulator : ILegBus
+    {
+        #region FIELDS
+
+        /** @brief   True if the leg is on the right side (address 0x2X). */
+        private bool right = false;
+
+        /** @brief   True if the leg can sense the ground (command 6). */
+        private bool sensing = false;
+
+        /** @brief   The last beta angle in degrees. */
+        private int lastBeta = 0;
+
+        /** @brief   The last gamma angle in degrees. */
+        private int lastGamma = 0;
+
+        /** @brief   A flag for the status of the ground contact. */
+        private bool grounded = false;
+
+        /** @brief   The last z position. */
+        protected int lastZPos = 0;
+
+        #endregion FIELDS
+
+        #region CONSTANTS
+
+        /** @brief   The height of the first joint. */
+        private const double zOffset = 88;
+
+        /** @brief   The distance between the first and second joint in mm. */
+        private const double A1 = 52;
+
+        /** @brief   The lenght of the upper leg in mm. */
+        private const double A2 = 69;
+
+        /** @brief   The lenght of the lower leg in mm. */
+        private const double A3 = 88;
+
+        /** @brief   The lowest z position while sensing the ground. */
+        private const int senseMin = -20;
+
+        #endregion CONSTANTS
+
+        #region Arrays
+
+        /** @brief   The servo calibration values in degrees (s0,s1,s2). */
+        private int[] cal = new int[3];
+
+        #endregion Arrays
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  protected LegEmulator(byte address, bool sensing)
+         *
+         * @brief   Constructor
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   address The i2c address (0x1X = left, 0x2X = right).
+         * @param   sensing True if the leg can sense the ground.
+         */
+
+        protected LegEmulator(byte address, bool sensing)
+        {
+            right = (address & 0x20) != 0;
+            this.sensing = sensing;
+        }
+
+
+
+        /**
+         * @fn  public bool write(byte[] data)
+         *
+         * @brief   Executes a command of the legcontroller protocol
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   data    The frame (command and parameters).
+         *
+         * @return  Always true.
+         */
+
+        public bool write(byte[] data)
+        {
+            if (data.Length < 4)
+            {
+                //0 = init, 1 = led color, 5 = reset -> nothing to emulate
+                return true;
+            }
+
+            switch (data[0])
+            {
+                case 2: //Set servo degree
+                    setDeg((sbyte)data[1], (sbyte)data[2], (sbyte)data[3]);
+                    break;
+                case 3: //Set leg position
+                    setPosition((sbyte)data[1], (sbyte)data[2], (sbyte)data[3]);
+                    break;
+                case 4: //Set servo calibration value
+                    cal[0] = (sbyte)data[1];
+                    cal[1] = (sbyte)data[2];
+                    cal[2] = (sbyte)data[3];
+                    break;
+                case 6: //Set terrain mode
+                    senseTerrain((sbyte)data[1], (sbyte)data[2], (sbyte)data[3]);
+                    break;
+                default:
+                    break;
+            }
+            return true;
+        }
+
+
+
+        /**
+         * @fn  public bool read(byte[] data)
+         *
+         * @brief   Reads the current z position of the TCP
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   data    The buffer.
+         *
+         * @return  True.
+         */
+
+        public bool read(byte[] data)
+        {
+            if (data.Length > 0)
+            {
+                data[0] = (byte)lastZPos;
+            }
+            return true;
+        }
+
+
+
+        /**
+         * @fn  private void setPosition(int xPos, int yPos, int zPos)
+         *
+         * @brief   Set TCP position. Calculates the angles (inverse kinematics)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   xPos    x-coordinate.
+         * @param   yPos    y-coordinate.
+         * @param   zPos    z-coordinate.
+         */
+
+        private void setPosition(int xPos, int yPos, int zPos)
+        {
+            if (right)
+            {
+                xPos = -xPos;
+                yPos = -yPos;
+            }
+
+            lastZPos = zPos;
+
+            //ALPHA
+            double a = Math.Atan2(-xPos, A1 + A2 - yPos);
+
+            //BETA
+            double l1 = zOffset - zPos;
+            double l2 = A2 - yPos;
+            double l3 = Math.Sqrt(l1 * l1 + l2 * l2);
+
+            double b = Math.Acos(l1 / l3);
+            b = b + Math.Acos((A2 * A2 - A3 * A3 + l3 * l3) / (2 * A2 * l3));
+
+            //GAMMA
+            double c = Math.Acos((A3 * A3 - l3 * l3 + A2 * A2) / (2 * A3 * A2));
+
+            //RAD TO DEG (NaN -> 0 like the cast on the legcontroller)
+            int alpha = double.IsNaN(a) ? 0 : (int)(a * 180 / Math.PI);
+            int beta = double.IsNaN(b) ? 0 : (int)(b * 180 / Math.PI - 90);
+            int gamma = double.IsNaN(c) ? 0 : (int)(c * 180 / Math.PI - 90);
+
+            //if TCP is out of reach
+            if ((gamma == 0 && beta == 0) && (yPos > 10 || zPos < -10))
+            {
+                //set TCP to last possible position
+                setDeg(lastGamma, lastBeta, alpha);
+            }
+            else
+            {
+                setDeg(gamma, beta, alpha);
+                lastBeta = beta;
+                lastGamma = gamma;
+            }
+        }
+
+
+
+        /**
+         * @fn  private void senseTerrain(int xPos, int yPos, int zPos)
+         *
+         * @brief   Set TCP position and check ground contact
+         *          Without ground sensing the position is set directly.
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   xPos    The x position.
+         * @param   yPos    The y position.
+         * @param   zPos    The z position.
+         */
+
+        private void senseTerrain(int xPos, int yPos, int zPos)
+        {
+            if (!sensing)
+            {
+                setPosition(xPos, yPos, zPos);
+                return;
+            }
+
+            //if leg is in should be in the air
+            if (zPos > 0)
+            {
+                grounded = false;
+                setPosition(xPos, yPos, zPos);
+            }
+            //if leg should be grounded
+            else if (zPos == 0)
+            {
+                if (!grounded)
+                {
+                    //lower leg by 2mm until the ground is reached
+                    while (!grounded)
+                    {
+                        setPosition(xPos, yPos, lastZPos - 2);
+                        grounded = checkGround();
+                        //if tcp reaches maximum distance
+                        if (lastZPos <= senseMin)
+                        {
+                            grounded = true;
+                        }
+                    }
+                }
+                else
+                {
+                    setPosition(xPos, yPos, lastZPos);
+                }
+            }
+        }
+
+
+
+        /**
+         * @fn  private void setDeg(int s0, int s1, int s2)
+         *
+         * @brief   Set servo position via the angle (-90 - +90), including side and calibration
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   s0  Angle of servo 0.
+         * @param   s1  Angle of servo 1.
+         * @param   s2  Angle of servo 2.
+         */
+
+        private void setDeg(int s0, int s1, int s2)
+        {
+            if (right)
+            {
+                s0 = -s0;
+                s1 = -s1;
+            }
+
+            //Check if values are in range
+            s0 = Math.Max(-90, Math.Min(90, s0 + cal[0]));
+            s1 = Math.Max(-90, Math.Min(90, s1 + cal[1]));
+            s2 = Math.Max(-90, Math.Min(90, s2 + cal[2]));
+
+            setServos(s0, s1, s2);
+        }
+
+
+
+        /**
+         * @fn  protected virtual bool checkGround()
+         *
+         * @brief   Checks for ground contact
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  True if the leg touches the ground.
+         */
+
+        protected virtual bool checkGround()
+        {
+            return true;
+        }
+
+
+
+        /**
+         * @fn  protected abstract void setServos(int s0, int s1, int s2);
+         *
+         * @brief   Sets the servo angles
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   s0  Angle of servo 0 (gamma) in degrees.
+         * @param   s1  Angle of servo 1 (beta) in degrees.
+         * @param   s2  Angle of servo 2 (alpha) in degrees.
+         */
+
+        protected abstract void setServos(int s0, int s1, int s2);
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,195 @@
+﻿/**********************************************************************************************//**
+ * @file    MetricsEndpoint.cs
+ *
+ * @brief   Implements the metrics endpoint class.
+ **************************************************************************************************/
+
+using System;
+using System.Diagnostics;
+using System.IO;
+using System.Text;
+
+namespace HexPi
+{
+
+    /**
+     * @class   MetricsEndpoint
+     *
+     * @brief   Serves the metrics in the Prometheus text format over http on localhost (any path, GET only).
+     *          The listener of the platform accepts the connections, one request at a time on its own thread,
+     *          the control thread is never involved.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class MetricsEndpoint
+    {
+        #region Objects
+        /** @brief   Accepts the connections. */
+        IMetricsListener listener = null;
+
+        /** @brief   Writes the metrics. */
+        Action<TextWriter> source = null;
+        #endregion Objects
+
+        #region CONSTANTS
+        /** @brief   The maximum size of a request header in bytes. */
+        private const int maxRequest = 4096;
+        #endregion CONSTANTS
+
+        #region PROPERTIES
+
+        /**
+         * @property    public int Port
+         *
+         * @brief   Gets the port
+         *
+         * @return  The port (the chosen one if started with 0).
+         */
+
+        public int Port { get; private set; }
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public MetricsEndpoint(IMetricsListener listener, Action<TextWriter> source)
+         *
+         * @brief   Constructor
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   listener    Accepts the connections.
+         * @param   source      Writes the metrics.
+         */
+
+        public MetricsEndpoint(IMetricsListener listener, Action<TextWriter> source)
+        {
+            this.listener = listener;
+            this.source = source;
+        }
+
+
+
+        /**
+         * @fn  public void start(int port)
+         *
+         * @brief   Starts listening on localhost
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   port    The port (0 = any free port).
+         */
+
+        public void start(int port)
+        {
+            Port = listener.start(port, answer);
+            Debug.WriteLine("Info: Metrics on http://localhost:{0}/metrics", Port);
+        }
+
+
+
+        /**
+         * @fn  public void stop()
+         *
+         * @brief   Stops listening
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void stop()
+        {
+            listener.stop();
+        }
+
+
+
+        /**
+         * @fn  private void answer(Stream input, Stream output)
+         *
+         * @brief   Reads the request header and sends the metrics (errors are logged)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   input   The request.
+         * @param   output  The response.
+         */
+
+        private void answer(Stream input, Stream output)
+        {
+            try
+            {
+                respond(input, output);
+            }
+            catch (Exception e)
+            {
+                Debug.WriteLine("Error: Metrics request failed! " + e.Message);
+            }
+        }
+
+
+
+        /**
+         * @fn  private void respond(Stream input, Stream output)
+         *
+         * @brief   Reads the request header and sends the metrics
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   input   The request.
+         * @param   output  The response.
+         */
+
+        private void respond(Stream input, Stream output)
+        {
+            //read until the end of the header
+            byte[] request = new byte[maxRequest];
+            int length = 0;
+            while (length < request.Length)
+            {
+                int n = input.Read(request, length, request.Length - length);
+                if (n == 0)
+                {
+                    break;
+                }
+                length += n;
+                if (Encoding.ASCII.GetString(request, 0, length).Contains("\r\n\r\n"))
+                {
+                    break;
+                }
+            }
+
+            string status = "200 OK";
+            string body;
+            if (!Encoding.ASCII.GetString(request, 0, length).StartsWith("GET "))
+            {
+                status = "405 Method Not Allowed";
+                body = "";
+            }
+            else
+            {
+                StringWriter writer = new StringWriter(System.Globalization.CultureInfo.InvariantCulture);
+                source(writer);
+                body = writer.ToString();
+            }
+
+            byte[] content = Encoding.UTF8.GetBytes(body);
+            byte[] header = Encoding.ASCII.GetBytes("HTTP/1.1 " + status + "\r\n"
+                + "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                + "Content-Length: " + content.Length + "\r\n"
+                + "Connection: close\r\n\r\n");
+            output.Write(header, 0, header.Length);
+            output.Write(content, 0, content.Length);
+            output.Flush();
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,418 @@
+﻿/**********************************************************************************************//**
+ * @file    PipelinedBackend.cs
+ *
+ * @brief   Implements the pipelined backend class.
+ **************************************************************************************************/
+
+using System;
+using System.Diagnostics;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace HexPi
+{
+
+    /**
+     * @class   PipelinedBackend
+     *
+     * @brief   Sends the frames of the inner backend on a dedicated bus thread. The control thread only copies
+     *          the frames into a bounded lock-free queue, so the next tick is calculated while the current one
+     *          is transmitted. A read waits until all queued frames are sent (order of the protocol),
+     *          a full queue blocks the control thread until the bus catches up.
+     *          The bus thread is a long running task (the UWP framework has no Thread class).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class PipelinedBackend : IActuatorBackend
+    {
+
+        /**
+         * @struct  Statistics
+         *
+         * @brief   The statistics of the pipeline (times in microseconds).
+         */
+
+        public struct Statistics
+        {
+            /** @brief   The number of sent frames. */
+            public long Frames;
+            /** @brief   The number of sent ticks (flushes). */
+            public long Ticks;
+            /** @brief   The number of times the control thread waited for a full queue. */
+            public long Stalls;
+            /** @brief   The number of times a read waited for the queue. */
+            public long Drains;
+            /** @brief   The maximum number of queued frames. */
+            public int MaxDepth;
+            /** @brief   The mean time from the end of a tick until its last frame was sent. */
+            public double Latency;
+            /** @brief   The maximum time from the end of a tick until its last frame was sent. */
+            public double LatencyMax;
+        }
+
+        /**
+         * @class   Bus
+         *
+         * @brief   Queues the frames of a leg.
+         */
+
+        private class Bus : ILegBus
+        {
+            /** @brief   The pipeline. */
+            PipelinedBackend pipeline;
+            /** @brief   The bus of the leg in the inner backend. */
+            ILegBus inner;
+
+            public Bus(PipelinedBackend pipeline, ILegBus inner)
+            {
+                this.pipeline = pipeline;
+                this.inner = inner;
+            }
+
+            public bool write(byte[] data)
+            {
+                pipeline.enqueue(inner, data);
+                return true;
+            }
+
+            public bool read(byte[] data)
+            {
+                pipeline.drain();
+                return inner.read(data);
+            }
+        }
+
+        #region Objects
+        /** @brief   The backend that sends the frames. */
+        IActuatorBackend inner = null;
+
+        /** @brief   The queued frames. */
+        FrameQueue queue = null;
+
+        /** @brief   The bus thread. */
+        Task thread = null;
+
+        /** @brief   Wakes the bus thread. */
+        ManualResetEventSlim wake = new ManualResetEventSlim(false);
+
+        /** @brief   Set by the bus thread when the frames a read waits for are sent. */
+        ManualResetEventSlim drained = new ManualResetEventSlim(false);
+
+        /** @brief   Lock for the statistics. */
+        object statLock = new object();
+        #endregion Objects
+
+        #region FIELDS
+        /** @brief   1 while the bus thread waits for frames. */
+        private int sleeping = 0;
+
+        /** @brief   The number of queued frames (control thread). */
+        private long enqueued = 0;
+
+        /** @brief   The number of sent frames (bus thread). */
+        private long completed = 0;
+
+        /** @brief   The number of sent frames a read waits for (-1 = none). */
+        private long drainTarget = -1;
+
+        /** @brief   1 if the bus thread shall end. */
+        private int stopped = 0;
+
+        /** @brief   The statistics. */
+        private Statistics stats;
+
+        /** @brief   The sum of the latencies in stopwatch ticks. */
+        private double latencySum = 0;
+
+        /** @brief   The maximum latency in stopwatch ticks. */
+        private long latencyMax = 0;
+        #endregion FIELDS
+
+        #region PROPERTIES
+
+        /**
+         * @property    public bool Calibrated
+         *
+         * @brief   Gets whether the legs of the inner backend are calibrated
+         *
+         * @return  True if the legs are calibrated.
+         */
+
+        public bool Calibrated => inner.Calibrated;
+
+        /**
+         * @property    public long FramePeriod
+         *
+         * @brief   Gets the period of the servo signals of the inner backend
+         *
+         * @return  The period in microseconds.
+         */
+
+        public long FramePeriod => inner.FramePeriod;
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public PipelinedBackend(IActuatorBackend inner, int capacity)
+         *
+         * @brief   Constructor, starts the bus thread
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   inner       The backend that sends the frames.
+         * @param   capacity    The maximum number of queued frames.
+         */
+
+        public PipelinedBackend(IActuatorBackend inner, int capacity)
+        {
+            this.inner = inner;
+            queue = new FrameQueue(capacity);
+
+            thread = Task.Factory.StartNew(run, TaskCreationOptions.LongRunning);
+        }
+
+        /**
+         * @fn  public ILegBus open(byte address, int index)
+         *
+         * @brief   Opens the bus of a leg in the inner backend
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   address The i2c address.
+         * @param   index   The position of the leg (0 - 5).
+         *
+         * @return  The queueing bus of the leg.
+         */
+
+        public ILegBus open(byte address, int index)
+        {
+            return new Bus(this, inner.open(address, index));
+        }
+
+        /**
+         * @fn  public void flush()
+         *
+         * @brief   Queues the end of the tick, the bus thread flushes the inner backend
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void flush()
+        {
+            enqueue(null, null);
+        }
+
+        /**
+         * @fn  public void drain()
+         *
+         * @brief   Waits until all queued frames are sent (sleeps until the bus thread sets drained)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void drain()
+        {
+            if (Volatile.Read(ref completed) == enqueued)
+            {
+                return;
+            }
+
+            lock (statLock)
+            {
+                stats.Drains++;
+            }
+            while (true)
+            {
+                drained.Reset();
+                Interlocked.Exchange(ref drainTarget, enqueued);
+                //the last frame may have been sent before the target was set
+                if (Volatile.Read(ref completed) == enqueued)
+                {
+                    break;
+                }
+                drained.Wait();
+            }
+            Interlocked.Exchange(ref drainTarget, -1);
+        }
+
+        /**
+         * @fn  public void stop()
+         *
+         * @brief   Sends the queued frames and ends the bus thread (the backend can not be used afterwards)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void stop()
+        {
+            if (thread == null)
+            {
+                return;
+            }
+            drain();
+            Interlocked.Exchange(ref stopped, 1);
+            wake.Set();
+            thread.Wait();
+            thread = null;
+        }
+
+        /**
+         * @fn  public Statistics getStatistics()
+         *
+         * @brief   Gets the statistics
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The statistics.
+         */
+
+        public Statistics getStatistics()
+        {
+            double us = 1000000.0 / Stopwatch.Frequency;
+            lock (statLock)
+            {
+                Statistics s = stats;
+                s.Latency = s.Ticks > 0 ? latencySum / s.Ticks * us : 0;
+                s.LatencyMax = latencyMax * us;
+                return s;
+            }
+        }
+
+        /**
+         * @fn  private void enqueue(ILegBus bus, byte[] data)
+         *
+         * @brief   Copies a frame into the queue and wakes the bus thread (control thread)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   bus     The bus of the leg (null = flush).
+         * @param   data    The data (null = flush).
+         */
+
+        private void enqueue(ILegBus bus, byte[] data)
+        {
+            FrameQueue.Frame frame = queue.reserve();
+            if (frame == null)
+            {
+                lock (statLock)
+                {
+                    stats.Stalls++;
+                }
+                SpinWait spin = new SpinWait();
+                while ((frame = queue.reserve()) == null)
+                {
+                    spin.SpinOnce();
+                }
+            }
+
+            frame.set(bus, data, Stopwatch.GetTimestamp());
+            queue.publish();
+            enqueued++;
+
+            int depth = queue.Count;
+            if (depth > stats.MaxDepth)
+            {
+                lock (statLock)
+                {
+                    stats.MaxDepth = Math.Max(stats.MaxDepth, depth);
+                }
+            }
+
+            //wake the bus thread if it sleeps
+            if (Interlocked.CompareExchange(ref sleeping, 0, 1) == 1)
+            {
+                wake.Set();
+            }
+        }
+
+        /**
+         * @fn  private void run()
+         *
+         * @brief   The bus thread. Sends the queued frames in order and sleeps while the queue is empty.
+         *          Ends when the queue is empty after stop().
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        private void run()
+        {
+#if NETCOREAPP3_0_OR_GREATER
+            //dedicated thread of the long running task
+            Thread.CurrentThread.Name = "HexPi bus";
+            Thread.CurrentThread.Priority = ThreadPriority.AboveNormal;
+#endif
+            while (true)
+            {
+                FrameQueue.Frame frame = queue.peek();
+                if (frame == null)
+                {
+                    if (Volatile.Read(ref stopped) == 1)
+                    {
+                        return;
+                    }
+                    Interlocked.Exchange(ref sleeping, 1);
+                    //a frame may have been queued before the flag was set
+                    if (queue.peek() != null && Interlocked.CompareExchange(ref sleeping, 0, 1) == 1)
+                    {
+                        continue;
+                    }
+                    wake.Wait();
+                    wake.Reset();
+                    continue;
+                }
+
+                try
+                {
+                    if (frame.Bus != null)
+                    {
+                        frame.Bus.write(frame.Data);
+                    }
+                    else
+                    {
+                        inner.flush();
+                    }
+                }
+                catch (Exception e)
+                {
+                    Debug.WriteLine("Error: Bus thread: " + e.Message);
+                }
+
+                long latency = Stopwatch.GetTimestamp() - frame.Timestamp;
+                bool tick = frame.Bus == null;
+                queue.release();
+                if (Interlocked.Increment(ref completed) == Volatile.Read(ref drainTarget))
+                {
+                    drained.Set();
+                }
+
+                lock (statLock)
+                {
+                    if (tick)
+                    {
+                        stats.Ticks++;
+                        latencySum += latency;
+                        latencyMax = Math.Max(latencyMax, latency);
+                    }
+                    else
+                    {
+                        stats.Frames++;
+                    }
+                }
+            }
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,175 @@
+﻿/**********************************************************************************************//**
+ * @file    RecordingBackend.cs
+ *
+ * @brief   Implements the recording backend class.
+ **************************************************************************************************/
+
+using System.Collections.Generic;
+using System.Diagnostics;
+
+namespace HexPi
+{
+
+    /**
+     * @class   RecordingBackend
+     *
+     * @brief   Records every frame written to the legs in memory and passes it on to another backend.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class RecordingBackend : IActuatorBackend
+    {
+
+        /**
+         * @struct  Frame
+         *
+         * @brief   A recorded frame.
+         */
+
+        public struct Frame
+        {
+            /** @brief   The time of the write (Stopwatch ticks). */
+            public long Timestamp;
+            /** @brief   The tick in which the frame was written. */
+            public long Tick;
+            /** @brief   The position of the leg (0 - 5). */
+            public int Index;
+            /** @brief   The frame (command and parameters). */
+            public byte[] Data;
+        }
+
+        /**
+         * @class   Bus
+         *
+         * @brief   The recording bus of one leg.
+         */
+
+        private class Bus : ILegBus
+        {
+            /** @brief   The backend. */
+            RecordingBackend recorder;
+            /** @brief   The bus of the leg in the inner backend. */
+            ILegBus inner;
+            /** @brief   The position of the leg. */
+            int index;
+
+            public Bus(RecordingBackend recorder, ILegBus inner, int index)
+            {
+                this.recorder = recorder;
+                this.inner = inner;
+                this.index = index;
+            }
+
+            public bool write(byte[] data)
+            {
+                recorder.Frames.Add(new Frame { Timestamp = Stopwatch.GetTimestamp(), Tick = recorder.tick, Index = index, Data = (byte[])data.Clone() });
+                return inner.write(data);
+            }
+
+            public bool read(byte[] data)
+            {
+                return inner.read(data);
+            }
+        }
+
+        #region Objects
+        /** @brief   The backend receiving the frames. */
+        IActuatorBackend inner = null;
+        #endregion Objects
+
+        #region FIELDS
+        /** @brief   The current tick. */
+        private long tick = 0;
+        #endregion FIELDS
+
+        #region PROPERTIES
+
+        /**
+         * @property    public List<Frame> Frames
+         *
+         * @brief   Gets the recorded frames
+         *
+         * @return  The frames.
+         */
+
+        public List<Frame> Frames { get; } = new List<Frame>();
+
+        /**
+         * @property    public bool Calibrated
+         *
+         * @brief   Gets whether the legs of the inner backend are calibrated
+         *
+         * @return  True if the legs are calibrated.
+         */
+
+        public bool Calibrated => inner.Calibrated;
+
+        /**
+         * @property    public long FramePeriod
+         *
+         * @brief   Gets the period of the servo signals of the inner backend
+         *
+         * @return  The period in microseconds.
+         */
+
+        public long FramePeriod => inner.FramePeriod;
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public RecordingBackend(IActuatorBackend inner)
+         *
+         * @brief   Constructor
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   inner   The backend receiving the frames.
+         */
+
+        public RecordingBackend(IActuatorBackend inner)
+        {
+            this.inner = inner;
+        }
+
+        /**
+         * @fn  public ILegBus open(byte address, int index)
+         *
+         * @brief   Opens the bus of a leg in the inner backend and records it
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   address The i2c address.
+         * @param   index   The position of the leg (0 - 5).
+         *
+         * @return  The recording bus of the leg.
+         */
+
+        public ILegBus open(byte address, int index)
+        {
+            return new Bus(this, inner.open(address, index), index);
+        }
+
+        /**
+         * @fn  public void flush()
+         *
+         * @brief   Flushes the inner backend and starts the next tick
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void flush()
+        {
+            inner.flush();
+            tick++;
+        }
+
+        #endregion FUNCTIONS
+    }
+}
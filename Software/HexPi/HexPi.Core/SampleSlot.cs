@@ -0,0 +1,108 @@
+﻿/**********************************************************************************************//**
+ * @file    SampleSlot.cs
+ *
+ * @brief   Implements the sample slot class.
+ **************************************************************************************************/
+
+using System.Threading;
+
+namespace HexPi
+{
+
+    /**
+     * @class   SampleSlot
+     *
+     * @brief   Holds the latest sample of one writer thread for any number of readers without a lock (sequence lock).
+     *          The version is odd while the writer copies a sample, a reader retries until it copied a sample
+     *          with the same even version before and after. Neither side allocates.
+     *
+     * @tparam  T   The sample.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class SampleSlot<T> where T : struct
+    {
+        #region FIELDS
+        /** @brief   The version (odd while writing). */
+        private int version = 0;
+
+        /** @brief   The sample. */
+        private T sample;
+        #endregion FIELDS
+
+        #region PROPERTIES
+
+        /**
+         * @property    public int Version
+         *
+         * @brief   Gets the number of published samples
+         *
+         * @return  The number of samples.
+         */
+
+        public int Version
+        {
+            get { return Volatile.Read(ref version) / 2; }
+        }
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public void publish(T value)
+         *
+         * @brief   Publishes a sample (only one thread may publish)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   value   The sample.
+         */
+
+        public void publish(T value)
+        {
+            int v = version;
+            Volatile.Write(ref version, v + 1);
+            Interlocked.MemoryBarrier();
+            sample = value;
+            Volatile.Write(ref version, v + 2);
+        }
+
+
+
+        /**
+         * @fn  public T read()
+         *
+         * @brief   Reads the latest sample
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The sample (default before the first publish).
+         */
+
+        public T read()
+        {
+            SpinWait spin = new SpinWait();
+            while (true)
+            {
+                int v = Volatile.Read(ref version);
+                if ((v & 1) == 0)
+                {
+                    T value = sample;
+                    Interlocked.MemoryBarrier();
+                    if (Volatile.Read(ref version) == v)
+                    {
+                        return value;
+                    }
+                }
+                spin.SpinOnce();
+            }
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,215 @@
+﻿/**********************************************************************************************//**
+ * @file    SimulatedBackend.cs
+ *
+ * @brief   Implements the simulated backend class.
+ **************************************************************************************************/
+
+using System.Diagnostics;
+
+namespace HexPi
+{
+
+    /**
+     * @class   SimulatedBackend
+     *
+     * @brief   Simulated legcontrollers, no hardware needed.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class SimulatedBackend : IActuatorBackend
+    {
+
+        /**
+         * @class   Bus
+         *
+         * @brief   Delays the transfers of a simulated leg like an i2c bus. While the leg senses the ground
+         *          it does not answer (reads fail, writes are lost).
+         */
+
+        private class Bus : ILegBus
+        {
+            /** @brief   The backend (bus speed, sense time). */
+            SimulatedBackend backend;
+            /** @brief   The simulated leg. */
+            SimulatedLeg inner;
+            /** @brief   The end of the ground sensing (stopwatch ticks). */
+            long busyUntil = 0;
+
+            public Bus(SimulatedBackend backend, SimulatedLeg inner)
+            {
+                this.backend = backend;
+                this.inner = inner;
+            }
+
+            public bool write(byte[] data)
+            {
+                backend.transfer(data.Length);
+                long now = Stopwatch.GetTimestamp();
+                if (now < busyUntil)
+                {
+                    return false;
+                }
+
+                int zPos = inner.ZPos;
+                inner.write(data);
+
+                //command 6 lowers the leg in steps of 2mm until it touches the ground
+                int steps = (zPos - inner.ZPos) / 2;
+                if (data[0] == 6 && steps > 0)
+                {
+                    busyUntil = now + steps * backend.SenseTime * Stopwatch.Frequency / 1000000;
+                }
+                return true;
+            }
+
+            public bool read(byte[] data)
+            {
+                backend.transfer(data.Length);
+                if (Stopwatch.GetTimestamp() < busyUntil)
+                {
+                    return false;
+                }
+                return inner.read(data);
+            }
+        }
+
+        #region CONSTANTS
+        /** @brief   The time of the driver per transfer in microseconds. */
+        private const long transferOverhead = 50;
+        #endregion CONSTANTS
+
+        #region PROPERTIES
+
+        /**
+         * @property    public SimulatedLeg[] Legs
+         *
+         * @brief   Gets the simulated legs
+         *
+         * @return  The legs by position.
+         */
+
+        public SimulatedLeg[] Legs { get; } = new SimulatedLeg[6];
+
+        /**
+         * @property    public long Ticks
+         *
+         * @brief   Gets the number of flushes (ticks)
+         *
+         * @return  The number of ticks.
+         */
+
+        public long Ticks { get; private set; }
+
+        /**
+         * @property    public bool Calibrated
+         *
+         * @brief   The simulated legs need the calibration at startup
+         *
+         * @return  False.
+         */
+
+        public bool Calibrated => false;
+
+        /**
+         * @property    public long FramePeriod
+         *
+         * @brief   Gets or sets the period of the servo signals of the simulated legs in microseconds
+         *          (20ms like the legcontrollers, 0 = no limit)
+         *
+         * @return  The period.
+         */
+
+        public long FramePeriod { get; set; } = 20000;
+
+        /**
+         * @property    public int BusSpeed
+         *
+         * @brief   Gets or sets the simulated bus speed in Hz (0 = transfers take no time).
+         *          A transfer takes 9 bits per byte including the address plus the time of the driver.
+         *
+         * @return  The bus speed.
+         */
+
+        public int BusSpeed { get; set; }
+
+        /**
+         * @property    public long SenseTime
+         *
+         * @brief   Gets or sets the time a leg needs to lower the foot by one step (2mm) while it senses the
+         *          ground in microseconds (0 = sensing takes no time)
+         *
+         * @return  The time per step.
+         */
+
+        public long SenseTime { get; set; }
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public ILegBus open(byte address, int index)
+         *
+         * @brief   Creates a simulated leg
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   address The i2c address (side of the leg).
+         * @param   index   The position of the leg (0 - 5).
+         *
+         * @return  The simulated leg.
+         */
+
+        public ILegBus open(byte address, int index)
+        {
+            Legs[index] = new SimulatedLeg(address);
+            return new Bus(this, Legs[index]);
+        }
+
+        /**
+         * @fn  public void flush()
+         *
+         * @brief   Counts the ticks
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void flush()
+        {
+            Ticks++;
+        }
+
+        /**
+         * @fn  private void transfer(int length)
+         *
+         * @brief   Waits for the time of a transfer (the bus blocks the caller like the i2c driver)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   length  The number of data bytes.
+         */
+
+        private void transfer(int length)
+        {
+            int speed = BusSpeed;
+            if (speed <= 0)
+            {
+                return;
+            }
+
+            long us = (length + 1) * 9 * 1000000L / speed + transferOverhead;
+            long end = Stopwatch.GetTimestamp() + us * Stopwatch.Frequency / 1000000;
+            while (Stopwatch.GetTimestamp() < end)
+            {
+                //busy like the driver
+            }
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,124 @@
+﻿/**********************************************************************************************//**
+ * @file    SimulatedImu.cs
+ *
+ * @brief   Implements the simulated imu class.
+ **************************************************************************************************/
+
+using System.Diagnostics;
+
+namespace HexPi
+{
+
+    /**
+     * @class   SimulatedImu
+     *
+     * @brief   A simulated inertial sensor. Pitch and roll are set from outside (level by default).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class SimulatedImu : IImu
+    {
+        #region PROPERTIES
+
+        /**
+         * @property    public double Pitch
+         *
+         * @brief   Gets or sets the pitch
+         *
+         * @return  The pitch in rad.
+         */
+
+        public double Pitch { get; set; }
+
+        /**
+         * @property    public double Roll
+         *
+         * @brief   Gets or sets the roll
+         *
+         * @return  The roll in rad.
+         */
+
+        public double Roll { get; set; }
+
+        /**
+         * @property    public double PitchRate
+         *
+         * @brief   Gets or sets the pitch rate
+         *
+         * @return  The pitch rate in rad/s.
+         */
+
+        public double PitchRate { get; set; }
+
+        /**
+         * @property    public double RollRate
+         *
+         * @brief   Gets or sets the roll rate
+         *
+         * @return  The roll rate in rad/s.
+         */
+
+        public double RollRate { get; set; }
+
+        /**
+         * @property    public long Timestamp
+         *
+         * @brief   Gets the time of the last read
+         *
+         * @return  The timestamp (stopwatch ticks).
+         */
+
+        public long Timestamp { get; private set; }
+
+        /**
+         * @property    public long Reads
+         *
+         * @brief   Gets the number of reads
+         *
+         * @return  The number of reads.
+         */
+
+        public long Reads { get; private set; }
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public void read()
+         *
+         * @brief   Counts the reads and takes the time, the values stay as set
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void read()
+        {
+            Reads++;
+            Timestamp = Stopwatch.GetTimestamp();
+        }
+
+
+
+        /**
+         * @fn  public long takeBusTime()
+         *
+         * @brief   Gets the bus time since the last call (the simulation has no bus)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  0.
+         */
+
+        public long takeBusTime()
+        {
+            return 0;
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,74 @@
+﻿/**********************************************************************************************//**
+ * @file    SimulatedInput.cs
+ *
+ * @brief   Implements the simulated input class.
+ **************************************************************************************************/
+
+using System.Diagnostics;
+
+namespace HexPi
+{
+
+    /**
+     * @class   SimulatedInput
+     *
+     * @brief   A simulated input device. The reading is set from outside (headless host, replays).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class SimulatedInput : IInputSource
+    {
+        #region PROPERTIES
+
+        /**
+         * @property    public InputState State
+         *
+         * @brief   Gets or sets the current reading
+         *
+         * @return  The reading.
+         */
+
+        public InputState State { get; set; }
+
+        /**
+         * @property    public bool Connected
+         *
+         * @brief   Gets or sets whether the input device is connected
+         *
+         * @return  True if connected.
+         */
+
+        public bool Connected { get; set; } = true;
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public bool read(out InputState state)
+         *
+         * @brief   Gets the current reading (taken now unless the reading has its own timestamp)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param [out] state   The reading.
+         *
+         * @return  False if the input device is not connected.
+         */
+
+        public bool read(out InputState state)
+        {
+            state = State;
+            if (state.Timestamp == 0)
+            {
+                state.Timestamp = Stopwatch.GetTimestamp();
+            }
+            return Connected;
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,140 @@
+﻿/**********************************************************************************************//**
+ * @file    SimulatedLeg.cs
+ *
+ * @brief   Implements the simulated leg class.
+ **************************************************************************************************/
+
+namespace HexPi
+{
+
+    /**
+     * @class   SimulatedLeg
+     *
+     * @brief   A simulated legcontroller. Keeps the servo angles in memory and senses a ground at a given height.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class SimulatedLeg : LegEmulator
+    {
+        #region PROPERTIES
+
+        /**
+         * @property    public int Gamma
+         *
+         * @brief   Gets the angle of servo 0
+         *
+         * @return  The angle in degrees.
+         */
+
+        public int Gamma { get; private set; }
+
+        /**
+         * @property    public int Beta
+         *
+         * @brief   Gets the angle of servo 1
+         *
+         * @return  The angle in degrees.
+         */
+
+        public int Beta { get; private set; }
+
+        /**
+         * @property    public int Alpha
+         *
+         * @brief   Gets the angle of servo 2
+         *
+         * @return  The angle in degrees.
+         */
+
+        public int Alpha { get; private set; }
+
+        /**
+         * @property    public int ZPos
+         *
+         * @brief   Gets the z position of the TCP
+         *
+         * @return  The z coordinate.
+         */
+
+        public int ZPos
+        {
+            get
+            {
+                return lastZPos;
+            }
+        }
+
+        /**
+         * @property    public int GroundHeight
+         *
+         * @brief   Gets or sets the height of the ground below the leg (0 = flat ground)
+         *
+         * @return  The z coordinate of the ground.
+         */
+
+        public int GroundHeight { get; set; }
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public SimulatedLeg(byte address)
+         *
+         * @brief   Constructor
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   address The i2c address (side of the leg).
+         */
+
+        public SimulatedLeg(byte address) : base(address, true)
+        {
+        }
+
+
+
+        /**
+         * @fn  protected override bool checkGround()
+         *
+         * @brief   Checks for ground contact
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  True if the TCP reached the ground.
+         */
+
+        protected override bool checkGround()
+        {
+            return lastZPos <= GroundHeight;
+        }
+
+
+
+        /**
+         * @fn  protected override void setServos(int s0, int s1, int s2)
+         *
+         * @brief   Sets the servo angles
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   s0  Angle of servo 0 (gamma) in degrees.
+         * @param   s1  Angle of servo 1 (beta) in degrees.
+         * @param   s2  Angle of servo 2 (alpha) in degrees.
+         */
+
+        protected override void setServos(int s0, int s1, int s2)
+        {
+            Gamma = s0;
+            Beta = s1;
+            Alpha = s2;
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,140 @@
+﻿/**********************************************************************************************//**
+ * @file    TcpMetricsListener.cs
+ *
+ * @brief   Implements the TCP metrics listener class.
+ **************************************************************************************************/
+
+#if NETCOREAPP3_0_OR_GREATER
+using System;
+using System.IO;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading;
+
+namespace HexPi
+{
+
+    /**
+     * @class   TcpMetricsListener
+     *
+     * @brief   Accepts the connections of the metrics endpoint with a TcpListener on its own thread.
+     *          .NET Core only, the UWP framework has no TcpListener (SocketMetricsListener of the app).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class TcpMetricsListener : IMetricsListener
+    {
+        #region Objects
+        /** @brief   The listener. */
+        TcpListener listener = null;
+
+        /** @brief   The thread accepting the connections. */
+        Thread thread = null;
+
+        /** @brief   Answers a connection. */
+        Action<Stream, Stream> connected = null;
+        #endregion Objects
+
+        #region CONSTANTS
+        /** @brief   The time a client has to send its request in milliseconds. */
+        private const int timeout = 2000;
+        #endregion CONSTANTS
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public int start(int port, Action<Stream, Stream> connected)
+         *
+         * @brief   Starts listening on localhost
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   port        The port (0 = any free port).
+         * @param   connected   Answers a connection.
+         *
+         * @return  The port.
+         */
+
+        public int start(int port, Action<Stream, Stream> connected)
+        {
+            this.connected = connected;
+            listener = new TcpListener(IPAddress.Loopback, port);
+            listener.Start();
+
+            thread = new Thread(run);
+            thread.Name = "HexPi metrics";
+            thread.IsBackground = true;
+            thread.Start();
+            return ((IPEndPoint)listener.LocalEndpoint).Port;
+        }
+
+
+
+        /**
+         * @fn  public void stop()
+         *
+         * @brief   Stops listening and waits for the thread
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void stop()
+        {
+            if (listener == null)
+            {
+                return;
+            }
+            listener.Stop();
+            thread.Join();
+            listener = null;
+            thread = null;
+        }
+
+
+
+        /**
+         * @fn  private void run()
+         *
+         * @brief   Accepts connections until the listener is stopped
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        private void run()
+        {
+            while (true)
+            {
+                TcpClient client;
+                try
+                {
+                    client = listener.AcceptTcpClient();
+                }
+                catch (SocketException)
+                {
+                    //stopped
+                    return;
+                }
+                catch (ObjectDisposedException)
+                {
+                    return;
+                }
+
+                using (client)
+                {
+                    client.ReceiveTimeout = timeout;
+                    client.SendTimeout = timeout;
+                    NetworkStream stream = client.GetStream();
+                    connected(stream, stream);
+                }
+            }
+        }
+
+        #endregion FUNCTIONS
+    }
+}
+#endif
@@ -0,0 +1,47 @@
+﻿/**********************************************************************************************//**
+ * @file    TickCommand.cs
+ *
+ * @brief   Implements the tick command class.
+ **************************************************************************************************/
+
+namespace HexPi
+{
+
+    /**
+     * @class   TickCommand
+     *
+     * @brief   The movement of the robot in one tick, passed through the stages of the tick pipeline.
+     *          The fields that are not used by the direction are ignored.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class TickCommand
+    {
+        /** @brief   The movement (Controller.directions). */
+        public byte Direction;
+        /** @brief   The operating mode (Controller.modes). */
+        public byte Mode;
+        /** @brief   The increment of the x coordinate (walk, turn). */
+        public double X;
+        /** @brief   The increment of the y coordinate (walk). */
+        public double Y;
+        /** @brief   The factor of the radius (turn) or the increment of the rotation (rotate). */
+        public double R;
+        /** @brief   The yaw (pose). */
+        public double Yaw;
+        /** @brief   The pitch (pose). */
+        public double Pitch;
+        /** @brief   The roll (pose). */
+        public double Roll;
+        /** @brief   The distance to move on the x axis (pose). */
+        public double A;
+        /** @brief   The distance to move on the y axis (pose). */
+        public double B;
+        /** @brief   The distance to move on the z axis (pose). */
+        public double C;
+        /** @brief   The time of the input reading the movement is based on (stopwatch ticks, 0 = unknown). */
+        public long InputTimestamp;
+    }
+}
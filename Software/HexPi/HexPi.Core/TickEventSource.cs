@@ -0,0 +1,280 @@
+﻿/**********************************************************************************************//**
+ * @file    TickEventSource.cs
+ *
+ * @brief   Implements the tick event source class.
+ **************************************************************************************************/
+
+using System.Diagnostics;
+using System.Diagnostics.Tracing;
+
+namespace HexPi
+{
+
+    /**
+     * @class   TickEventSource
+     *
+     * @brief   Profiles the control loop with EventSource "HexPi-Tick" (dotnet-counters, dotnet-trace, PerfView).
+     *          Counters: the time of each stage (stage-<name>-time) and section (section-<name>-time),
+     *          .NET Core 3 and later.
+     *          Events (verbose): the time of each stage (keyword Stages) and each section (keyword Sections)
+     *          in every tick. Without a listener every call is one check of a field.
+     *
+     *          dotnet-counters monitor -n HexPi.Host --counters HexPi-Tick
+     *          dotnet-trace collect -n HexPi.Host --providers HexPi-Tick:0x3:5
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    [EventSource(Name = "HexPi-Tick")]
+    sealed class TickEventSource : EventSource
+    {
+
+        /**
+         * @class   Keywords
+         *
+         * @brief   The groups of events.
+         */
+
+        public static class Keywords
+        {
+            /** @brief   The time of each stage. */
+            public const EventKeywords Stages = (EventKeywords)1;
+            /** @brief   The time of each section. */
+            public const EventKeywords Sections = (EventKeywords)2;
+        }
+
+        #region Objects
+        /** @brief   The event source of the process. */
+        public static readonly TickEventSource Log = new TickEventSource();
+
+#if NETCOREAPP3_0_OR_GREATER
+        /** @brief   The counter of each stage (created on the first enable). */
+        EventCounter[] stageCounters = null;
+
+        /** @brief   The counter of each section (created on the first enable). */
+        EventCounter[] sectionCounters = null;
+#endif
+        #endregion Objects
+
+        #region Enums
+
+        /**
+         * @enum    sections
+         *
+         * @brief   The measured parts of the stages
+         *          PATH = position of each leg on its path, GAIT = gait of all legs, IMU = reading of the accelerometer,
+         *          BALANCE = balance controller, POSE = pose of the body
+         */
+
+        public enum sections { PATH, GAIT, IMU, BALANCE, POSE };
+
+        #endregion Enums
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  private TickEventSource()
+         *
+         * @brief   Default constructor (only Log)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        private TickEventSource()
+        {
+        }
+
+
+
+        /**
+         * @fn  public long begin()
+         *
+         * @brief   Starts the measurement of a section
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The timestamp for end() (0 without a listener).
+         */
+
+        [NonEvent]
+        public long begin()
+        {
+            return IsEnabled() ? Stopwatch.GetTimestamp() : 0;
+        }
+
+
+
+        /**
+         * @fn  public void end(sections section, long start)
+         *
+         * @brief   Ends the measurement of a section
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   section The section.
+         * @param   start   The timestamp of begin().
+         */
+
+        [NonEvent]
+        public void end(sections section, long start)
+        {
+            if (start == 0)
+            {
+                return;
+            }
+
+            long elapsed = Stopwatch.GetTimestamp() - start;
+#if NETCOREAPP3_0_OR_GREATER
+            EventCounter[] counters = sectionCounters;
+            if (counters != null)
+            {
+                counters[(int)section].WriteMetric(elapsed * 1000000.0 / Stopwatch.Frequency);
+            }
+#endif
+            if (IsEnabled(EventLevel.Verbose, Keywords.Sections))
+            {
+                Section((int)section, nanoseconds(elapsed));
+            }
+        }
+
+
+
+        /**
+         * @fn  public void stage(TickPipeline.stages stage, long elapsed)
+         *
+         * @brief   Adds the time of a stage of the current tick
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   stage   The stage.
+         * @param   elapsed The time of the stage in stopwatch ticks.
+         */
+
+        [NonEvent]
+        public void stage(TickPipeline.stages stage, long elapsed)
+        {
+            if (!IsEnabled())
+            {
+                return;
+            }
+
+#if NETCOREAPP3_0_OR_GREATER
+            EventCounter[] counters = stageCounters;
+            if (counters != null)
+            {
+                counters[(int)stage].WriteMetric(elapsed * 1000000.0 / Stopwatch.Frequency);
+            }
+#endif
+            if (IsEnabled(EventLevel.Verbose, Keywords.Stages))
+            {
+                Stage((int)stage, nanoseconds(elapsed));
+            }
+        }
+
+
+
+        /**
+         * @fn  public void Stage(int Stage, int Duration)
+         *
+         * @brief   Event: a stage of a tick finished
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   Stage       The stage (TickPipeline.stages).
+         * @param   Duration    The time of the stage in nanoseconds.
+         */
+
+        [Event(1, Level = EventLevel.Verbose, Keywords = Keywords.Stages)]
+        public void Stage(int Stage, int Duration)
+        {
+            WriteEvent(1, Stage, Duration);
+        }
+
+
+
+        /**
+         * @fn  public void Section(int Section, int Duration)
+         *
+         * @brief   Event: a section of a stage finished
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   Section     The section (sections).
+         * @param   Duration    The time of the section in nanoseconds.
+         */
+
+        [Event(2, Level = EventLevel.Verbose, Keywords = Keywords.Sections)]
+        public void Section(int Section, int Duration)
+        {
+            WriteEvent(2, Section, Duration);
+        }
+
+
+
+        /**
+         * @fn  protected override void OnEventCommand(EventCommandEventArgs command)
+         *
+         * @brief   Creates the counters when a listener enables the source
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   command The command.
+         */
+
+        protected override void OnEventCommand(EventCommandEventArgs command)
+        {
+#if NETCOREAPP3_0_OR_GREATER
+            if (command.Command == EventCommand.Enable && stageCounters == null)
+            {
+                string[] stageNames = System.Enum.GetNames(typeof(TickPipeline.stages));
+                EventCounter[] stages = new EventCounter[stageNames.Length];
+                for (int i = 0; i < stages.Length; i++)
+                {
+                    stages[i] = new EventCounter("stage-" + stageNames[i].ToLower() + "-time", this) { DisplayName = "Stage " + stageNames[i].ToLower(), DisplayUnits = "us" };
+                }
+
+                string[] sectionNames = System.Enum.GetNames(typeof(sections));
+                EventCounter[] parts = new EventCounter[sectionNames.Length];
+                for (int i = 0; i < parts.Length; i++)
+                {
+                    parts[i] = new EventCounter("section-" + sectionNames[i].ToLower() + "-time", this) { DisplayName = "Section " + sectionNames[i].ToLower(), DisplayUnits = "us" };
+                }
+
+                sectionCounters = parts;
+                stageCounters = stages;
+            }
+#endif
+        }
+
+
+
+        /**
+         * @fn  private static int nanoseconds(long elapsed)
+         *
+         * @brief   Converts stopwatch ticks to nanoseconds
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   elapsed The time in stopwatch ticks.
+         *
+         * @return  The time in nanoseconds (at most about 2s).
+         */
+
+        private static int nanoseconds(long elapsed)
+        {
+            long ns = elapsed * 1000000000 / Stopwatch.Frequency;
+            return ns > int.MaxValue ? int.MaxValue : (int)ns;
+        }
+
+        #endregion FUNCTIONS
+    }
+}
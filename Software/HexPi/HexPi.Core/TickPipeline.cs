@@ -0,0 +1,319 @@
+﻿/**********************************************************************************************//**
+ * @file    TickPipeline.cs
+ *
+ * @brief   Implements the tick pipeline class.
+ **************************************************************************************************/
+
+using System;
+using System.Diagnostics;
+
+namespace HexPi
+{
+
+    /**
+     * @class   TickPipeline
+     *
+     * @brief   Runs the stages of a tick in order and measures the time of each stage.
+     *          input (change of direction) -> gait -> balance/pose -> encode (frames to the legs) -> transmit (flush)
+     *          -> feedback (ground sensing). A stage can be replaced, an empty stage is skipped.
+     *          If the command carries the time of its input reading, the latency from the reading to the end
+     *          of each stage is counted (the end of transmit is the time the operator feels).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class TickPipeline
+    {
+
+        /**
+         * @struct  Statistics
+         *
+         * @brief   The time of a stage since the last reset (times in microseconds).
+         */
+
+        public struct Statistics
+        {
+            /** @brief   The number of ticks. */
+            public long Ticks;
+            /** @brief   The mean time of the stage. */
+            public double Mean;
+            /** @brief   The maximum time of the stage. */
+            public double Max;
+        }
+
+        #region Objects
+        /** @brief   Lock for the statistics. */
+        object statLock = new object();
+        #endregion Objects
+
+        #region FIELDS
+        /** @brief   The number of ticks. */
+        private long ticks = 0;
+        #endregion FIELDS
+
+        #region Arrays
+        /** @brief   The stages. */
+        private ITickStage[] stageList = new ITickStage[Enum.GetValues(typeof(stages)).Length];
+
+        /** @brief   The timestamps of the current tick (before each stage and after the last one). */
+        private long[] timestamps = new long[Enum.GetValues(typeof(stages)).Length + 1];
+
+        /** @brief   The sum of the times of each stage in stopwatch ticks. */
+        private long[] sum = new long[Enum.GetValues(typeof(stages)).Length];
+
+        /** @brief   The maximum time of each stage in stopwatch ticks. */
+        private long[] max = new long[Enum.GetValues(typeof(stages)).Length];
+
+        /** @brief   The latency from the input reading to the end of each stage. */
+        private LatencyHistogram[] latency = createHistograms(Enum.GetValues(typeof(stages)).Length);
+        #endregion Arrays
+
+        #region Enums
+
+        /**
+         * @enum    stages
+         *
+         * @brief   The stages of a tick in the order they run
+         */
+
+        public enum stages { INPUT, GAIT, POSE, ENCODE, TRANSMIT, FEEDBACK };
+
+        #endregion Enums
+
+        #region PROPERTIES
+
+        /**
+         * @property    public long LastTick
+         *
+         * @brief   Gets the start of the last tick
+         *
+         * @return  The timestamp (stopwatch ticks).
+         */
+
+        public long LastTick
+        {
+            get { return timestamps[0]; }
+        }
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public ITickStage getStage(stages stage)
+         *
+         * @brief   Gets a stage
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   stage   The stage.
+         *
+         * @return  The stage or null if empty.
+         */
+
+        public ITickStage getStage(stages stage)
+        {
+            return stageList[(int)stage];
+        }
+
+
+
+        /**
+         * @fn  public void setStage(stages stage, ITickStage implementation)
+         *
+         * @brief   Sets or replaces a stage (not while a tick runs)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   stage           The stage.
+         * @param   implementation  The implementation or null to skip the stage.
+         */
+
+        public void setStage(stages stage, ITickStage implementation)
+        {
+            stageList[(int)stage] = implementation;
+        }
+
+
+
+        /**
+         * @fn  public void run(TickCommand command)
+         *
+         * @brief   Runs all stages for one tick
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   command The movement of the tick.
+         */
+
+        public void run(TickCommand command)
+        {
+            for (int i = 0; i < stageList.Length; i++)
+            {
+                timestamps[i] = Stopwatch.GetTimestamp();
+                if (stageList[i] != null)
+                {
+                    stageList[i].run(command);
+                }
+            }
+            timestamps[stageList.Length] = Stopwatch.GetTimestamp();
+
+            if (TickEventSource.Log.IsEnabled())
+            {
+                for (int i = 0; i < stageList.Length; i++)
+                {
+                    TickEventSource.Log.stage((stages)i, timestamps[i + 1] - timestamps[i]);
+                }
+            }
+
+            lock (statLock)
+            {
+                ticks++;
+                for (int i = 0; i < stageList.Length; i++)
+                {
+                    long time = timestamps[i + 1] - timestamps[i];
+                    sum[i] += time;
+                    if (time > max[i])
+                    {
+                        max[i] = time;
+                    }
+                    if (command.InputTimestamp != 0)
+                    {
+                        latency[i].add((timestamps[i + 1] - command.InputTimestamp) * 1000000 / Stopwatch.Frequency);
+                    }
+                }
+            }
+        }
+
+
+
+        /**
+         * @fn  public long getTime(stages stage)
+         *
+         * @brief   Gets the time of a stage in the last tick (control thread)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   stage   The stage.
+         *
+         * @return  The time in stopwatch ticks.
+         */
+
+        public long getTime(stages stage)
+        {
+            return timestamps[(int)stage + 1] - timestamps[(int)stage];
+        }
+
+
+
+        /**
+         * @fn  public Statistics getStatistics(stages stage)
+         *
+         * @brief   Gets the time of a stage since the last reset
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   stage   The stage.
+         *
+         * @return  The statistics.
+         */
+
+        public Statistics getStatistics(stages stage)
+        {
+            double us = 1000000.0 / Stopwatch.Frequency;
+            Statistics s = new Statistics();
+
+            lock (statLock)
+            {
+                s.Ticks = ticks;
+                if (ticks > 0)
+                {
+                    s.Mean = (double)sum[(int)stage] / ticks * us;
+                    s.Max = max[(int)stage] * us;
+                }
+            }
+            return s;
+        }
+
+
+
+        /**
+         * @fn  public LatencyHistogram.Summary getLatency(stages stage)
+         *
+         * @brief   Gets the latency from the input reading to the end of a stage since the last reset
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   stage   The stage.
+         *
+         * @return  The percentiles in microseconds.
+         */
+
+        public LatencyHistogram.Summary getLatency(stages stage)
+        {
+            lock (statLock)
+            {
+                return latency[(int)stage].getSummary();
+            }
+        }
+
+
+
+        /**
+         * @fn  public void resetStatistics()
+         *
+         * @brief   Resets the statistics
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void resetStatistics()
+        {
+            lock (statLock)
+            {
+                ticks = 0;
+                Array.Clear(sum, 0, sum.Length);
+                Array.Clear(max, 0, max.Length);
+                foreach (LatencyHistogram h in latency)
+                {
+                    h.reset();
+                }
+            }
+        }
+
+
+
+        /**
+         * @fn  private static LatencyHistogram[] createHistograms(int count)
+         *
+         * @brief   Creates a histogram for each stage
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   count   The number of stages.
+         *
+         * @return  The histograms.
+         */
+
+        private static LatencyHistogram[] createHistograms(int count)
+        {
+            LatencyHistogram[] histograms = new LatencyHistogram[count];
+            for (int i = 0; i < count; i++)
+            {
+                histograms[i] = new LatencyHistogram();
+            }
+            return histograms;
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,379 @@
+﻿/**********************************************************************************************//**
+ * @file    TickScheduler.cs
+ *
+ * @brief   Implements the tick scheduler class.
+ **************************************************************************************************/
+
+using System;
+using System.Diagnostics;
+using System.Threading;
+
+namespace HexPi
+{
+
+    /**
+     * @class   TickScheduler
+     *
+     * @brief   Runs a tick at a fixed rate. The deadlines are absolute (no drift), the thread sleeps until
+     *          shortly before a deadline and spins only for the rest. The spin time is calibrated with the
+     *          measured oversleep of the system timer but never longer than 200us, on coarse timers the
+     *          thread yields instead (more jitter, but the cpu stays free).
+     *          A tick that finishes after the next deadline is an overrun, deadlines that passed are skipped.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class TickScheduler
+    {
+
+        /**
+         * @struct  Statistics
+         *
+         * @brief   The statistics since the last reset (times in microseconds).
+         *          Jitter = start of a tick - its deadline.
+         */
+
+        public struct Statistics
+        {
+            /** @brief   The period. */
+            public double Period;
+            /** @brief   The number of ticks. */
+            public long Ticks;
+            /** @brief   The number of ticks that finished after the next deadline. */
+            public long Overruns;
+            /** @brief   The number of skipped deadlines. */
+            public long Skipped;
+            /** @brief   The minimum jitter. */
+            public double JitterMin;
+            /** @brief   The maximum jitter. */
+            public double JitterMax;
+            /** @brief   The mean jitter. */
+            public double JitterMean;
+            /** @brief   The standard deviation of the jitter. */
+            public double JitterStdDev;
+            /** @brief   The mean duration of a tick. */
+            public double DurationMean;
+            /** @brief   The maximum duration of a tick. */
+            public double DurationMax;
+            /** @brief   The current spin time in front of a deadline. */
+            public double Spin;
+        }
+
+        #region Objects
+        /** @brief   The clock. */
+        Stopwatch clock = Stopwatch.StartNew();
+
+        /** @brief   Set to stop the scheduler. */
+        ManualResetEvent stopEvent = new ManualResetEvent(false);
+
+        /** @brief   Lock for the statistics. */
+        object statLock = new object();
+        #endregion Objects
+
+        #region FIELDS
+        /** @brief   The period in stopwatch ticks (0 = run back to back). */
+        private long period = 0;
+
+        /** @brief   The spin time in front of a deadline in stopwatch ticks. */
+        private long spin = 0;
+
+        /** @brief   The minimum spin time in stopwatch ticks (100us). */
+        private readonly long minSpin = Stopwatch.Frequency / 10000;
+
+        /** @brief   The maximum spin time in stopwatch ticks (200us). */
+        private readonly long maxSpin = Stopwatch.Frequency / 5000;
+
+        /** @brief   The number of SpinWait rounds before it is reset (it yields from the 10th, sleeps 1ms from the 30th). */
+        private const int yieldRounds = 20;
+
+        /** @brief   The number of ticks. */
+        private long ticks = 0;
+        /** @brief   The number of overruns. */
+        private long overruns = 0;
+        /** @brief   The number of skipped deadlines. */
+        private long skipped = 0;
+        /** @brief   The minimum jitter in stopwatch ticks. */
+        private long jitterMin = long.MaxValue;
+        /** @brief   The maximum jitter in stopwatch ticks. */
+        private long jitterMax = 0;
+        /** @brief   The sum of the jitter in stopwatch ticks. */
+        private double jitterSum = 0;
+        /** @brief   The sum of the squared jitter in stopwatch ticks. */
+        private double jitterSqSum = 0;
+        /** @brief   The sum of the tick durations in stopwatch ticks. */
+        private double durationSum = 0;
+        /** @brief   The maximum tick duration in stopwatch ticks. */
+        private long durationMax = 0;
+        #endregion FIELDS
+
+        #region PROPERTIES
+
+        /**
+         * @property    public long Period
+         *
+         * @brief   Gets or sets the period in microseconds (0 = run back to back), used from the next deadline on
+         *
+         * @return  The period.
+         */
+
+        public long Period
+        {
+            get { return Interlocked.Read(ref period) * 1000000 / Stopwatch.Frequency; }
+            set { Interlocked.Exchange(ref period, value * Stopwatch.Frequency / 1000000); }
+        }
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public TickScheduler(long period)
+         *
+         * @brief   Constructor
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   period  The period in microseconds.
+         */
+
+        public TickScheduler(long period)
+        {
+            Period = period;
+            spin = maxSpin;
+        }
+
+
+
+        /**
+         * @fn  public void run(Action tick)
+         *
+         * @brief   Runs the tick at the period until stop() is called (blocks the calling thread)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   tick    The tick.
+         */
+
+        public void run(Action tick)
+        {
+            stopEvent.Reset();
+            long deadline = clock.ElapsedTicks;
+
+            while (true)
+            {
+                long p = Interlocked.Read(ref period);
+
+                if (p > 0)
+                {
+                    if (!waitUntil(deadline, p))
+                    {
+                        return;
+                    }
+                }
+                else if (stopEvent.WaitOne(0))
+                {
+                    return;
+                }
+
+                long start = clock.ElapsedTicks;
+                long jitter = p > 0 ? start - deadline : 0;
+                tick();
+                long end = clock.ElapsedTicks;
+
+                long missed = 0;
+                if (p > 0)
+                {
+                    deadline += p;
+                    //finished after the next deadline -> skip the deadlines that passed
+                    if (end >= deadline)
+                    {
+                        missed = (end - deadline) / p + 1;
+                        deadline += missed * p;
+                    }
+                }
+                else
+                {
+                    deadline = end;
+                }
+
+                record(jitter, end - start, missed);
+            }
+        }
+
+
+
+        /**
+         * @fn  public void stop()
+         *
+         * @brief   Stops the scheduler after the current tick (wakes it up if it is waiting)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void stop()
+        {
+            stopEvent.Set();
+        }
+
+
+
+        /**
+         * @fn  public Statistics getStatistics()
+         *
+         * @brief   Gets the statistics since the last reset
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The statistics.
+         */
+
+        public Statistics getStatistics()
+        {
+            double us = 1000000.0 / Stopwatch.Frequency;
+            Statistics s = new Statistics();
+
+            lock (statLock)
+            {
+                s.Period = Interlocked.Read(ref period) * us;
+                s.Ticks = ticks;
+                s.Overruns = overruns;
+                s.Skipped = skipped;
+                s.Spin = Interlocked.Read(ref spin) * us;
+                if (ticks > 0)
+                {
+                    double mean = jitterSum / ticks;
+                    s.JitterMin = jitterMin * us;
+                    s.JitterMax = jitterMax * us;
+                    s.JitterMean = mean * us;
+                    s.JitterStdDev = Math.Sqrt(Math.Max(0, jitterSqSum / ticks - mean * mean)) * us;
+                    s.DurationMean = durationSum / ticks * us;
+                    s.DurationMax = durationMax * us;
+                }
+            }
+            return s;
+        }
+
+
+
+        /**
+         * @fn  public void resetStatistics()
+         *
+         * @brief   Resets the statistics
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void resetStatistics()
+        {
+            lock (statLock)
+            {
+                ticks = 0;
+                overruns = 0;
+                skipped = 0;
+                jitterMin = long.MaxValue;
+                jitterMax = 0;
+                jitterSum = 0;
+                jitterSqSum = 0;
+                durationSum = 0;
+                durationMax = 0;
+            }
+        }
+
+
+
+        /**
+         * @fn  private bool waitUntil(long deadline, long p)
+         *
+         * @brief   Sleeps until shortly before the deadline and spins for the rest.
+         *          The oversleep of every sleep adapts the spin time (doubles at most per sleep, so a single
+         *          late wakeup does not cost much cpu, decays slowly, limited to 200us and half of the period).
+         *          Less than a millisecond before the spin time the thread yields, it can not sleep that short.
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   deadline    The deadline in stopwatch ticks.
+         * @param   p           The period in stopwatch ticks.
+         *
+         * @return  False if the scheduler was stopped.
+         */
+
+        private bool waitUntil(long deadline, long p)
+        {
+            SpinWait yield = new SpinWait();
+            while (true)
+            {
+                long now = clock.ElapsedTicks;
+                long remaining = deadline - now;
+                if (remaining <= 0)
+                {
+                    return !stopEvent.WaitOne(0);
+                }
+
+                long sleep = remaining - spin;
+                int ms = (int)(sleep * 1000 / Stopwatch.Frequency);
+                if (ms >= 1)
+                {
+                    if (stopEvent.WaitOne(ms))
+                    {
+                        return false;
+                    }
+                    long overslept = clock.ElapsedTicks - now - ms * Stopwatch.Frequency / 1000;
+                    long s = overslept > spin ? Math.Min(overslept, 2 * spin) : spin - spin / 64;
+                    Interlocked.Exchange(ref spin, Math.Max(minSpin, Math.Min(Math.Min(p / 2, maxSpin), s)));
+                }
+                else if (sleep > 0)
+                {
+                    //give the core away until the spin time, never sleep a whole millisecond
+                    if (yield.Count >= yieldRounds)
+                    {
+                        yield.Reset();
+                    }
+                    yield.SpinOnce();
+                }
+            }
+        }
+
+
+
+        /**
+         * @fn  private void record(long jitter, long duration, long missed)
+         *
+         * @brief   Adds a tick to the statistics
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   jitter      The jitter in stopwatch ticks.
+         * @param   duration    The duration in stopwatch ticks.
+         * @param   missed      The number of skipped deadlines.
+         */
+
+        private void record(long jitter, long duration, long missed)
+        {
+            lock (statLock)
+            {
+                ticks++;
+                if (missed > 0)
+                {
+                    overruns++;
+                    skipped += missed;
+                }
+                jitterMin = Math.Min(jitterMin, jitter);
+                jitterMax = Math.Max(jitterMax, jitter);
+                jitterSum += jitter;
+                jitterSqSum += (double)jitter * jitter;
+                durationSum += duration;
+                durationMax = Math.Max(durationMax, duration);
+            }
+        }
+
+        #endregion FUNCTIONS
+    }
+}
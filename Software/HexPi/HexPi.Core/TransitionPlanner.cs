@@ -0,0 +1,226 @@
+﻿/**********************************************************************************************//**
+ * @file    TransitionPlanner.cs
+ *
+ * @brief   Implements the transition planner class.
+ **************************************************************************************************/
+
+using System;
+
+namespace HexPi
+{
+
+    /**
+     * @class   TransitionPlanner
+     *
+     * @brief   Moves all legs from their current positions to the center (start of every gait) over several ticks.
+     *          First all legs are put down, then one tripod after the other is lifted, moved to the center
+     *          and put down again, so the other tripod always carries the robot. Each step is blended over
+     *          the same time (smoothstep), the planner advances by the period of each tick.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class TransitionPlanner
+    {
+        #region Objects
+        /** @brief   The gait and pose of all legs (positions are written here). */
+        BodyKinematics body = null;
+        #endregion Objects
+
+        #region FIELDS
+        /** @brief   The time since the start of the transition in microseconds. */
+        private long elapsed = 0;
+        #endregion FIELDS
+
+        #region CONSTANTS
+        /** @brief   The time of one step in microseconds. */
+        private const long stepTime = 100000;
+
+        /** @brief   The steps of a tripod (lift, move to the center, put down). */
+        private const int tripodSteps = 3;
+        #endregion CONSTANTS
+
+        #region Arrays
+        /** @brief   The tripods in the order they move. */
+        private int[][] tripods = null;
+
+        /** @brief   The tripod of each leg. */
+        private int[] tripodOf = null;
+
+        /** @brief   The x positions at the start of the transition. */
+        private double[] startX = null;
+
+        /** @brief   The y positions at the start of the transition. */
+        private double[] startY = null;
+
+        /** @brief   The z positions at the start of the transition. */
+        private double[] startZ = null;
+        #endregion Arrays
+
+        #region PROPERTIES
+
+        /**
+         * @property    public bool Active
+         *
+         * @brief   Gets whether a transition is running
+         *
+         * @return  True if active.
+         */
+
+        public bool Active { get; private set; }
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public TransitionPlanner(BodyKinematics body, int[][] tripods)
+         *
+         * @brief   Constructor
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   body    The gait and pose of all legs.
+         * @param   tripods The legs of each tripod in the order they move.
+         */
+
+        public TransitionPlanner(BodyKinematics body, int[][] tripods)
+        {
+            this.body = body;
+            this.tripods = tripods;
+
+            tripodOf = new int[body.Count];
+            for (int i = 0; i < tripods.Length; i++)
+            {
+                foreach (int leg in tripods[i])
+                {
+                    tripodOf[leg] = i;
+                }
+            }
+
+            startX = new double[body.Count];
+            startY = new double[body.Count];
+            startZ = new double[body.Count];
+        }
+
+
+
+        /**
+         * @fn  public void start()
+         *
+         * @brief   Starts a transition from the current positions (also while another transition runs)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void start()
+        {
+            Array.Copy(body.X, startX, body.Count);
+            Array.Copy(body.Y, startY, body.Count);
+            Array.Copy(body.Z, startZ, body.Count);
+            elapsed = 0;
+            Active = true;
+        }
+
+
+
+        /**
+         * @fn  public void step(long period)
+         *
+         * @brief   Advances the transition by one tick and sets the positions of all legs.
+         *          The transition ends in the tick that reaches the center.
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   period  The period of the tick in microseconds.
+         */
+
+        public void step(long period)
+        {
+            if (!Active)
+            {
+                return;
+            }
+
+            elapsed += period;
+            //step 0: all legs down, then the steps of each tripod
+            int current = (int)Math.Min(elapsed / stepTime, 1 + tripods.Length * tripodSteps);
+            double f = smooth((double)(elapsed - current * stepTime) / stepTime);
+
+            if (current == 1 + tripods.Length * tripodSteps)
+            {
+                Active = false;
+            }
+
+            for (int i = 0; i < body.Count; i++)
+            {
+                if (current == 0)
+                {
+                    body.X[i] = startX[i];
+                    body.Y[i] = startY[i];
+                    body.Z[i] = startZ[i] * (1 - f);
+                    continue;
+                }
+
+                //step of the tripod of the leg: < 0 = waiting, 0 = lift, 1 = move, 2 = down, > 2 = done
+                int s = current - 1 - tripodOf[i] * tripodSteps;
+                if (s < 0)
+                {
+                    body.X[i] = startX[i];
+                    body.Y[i] = startY[i];
+                    body.Z[i] = 0;
+                }
+                else if (s == 0)
+                {
+                    body.X[i] = startX[i];
+                    body.Y[i] = startY[i];
+                    body.Z[i] = BodyKinematics.stepSizeZ * f;
+                }
+                else if (s == 1)
+                {
+                    body.X[i] = startX[i] * (1 - f);
+                    body.Y[i] = startY[i] * (1 - f);
+                    body.Z[i] = BodyKinematics.stepSizeZ;
+                }
+                else if (s == 2)
+                {
+                    body.X[i] = 0;
+                    body.Y[i] = 0;
+                    body.Z[i] = BodyKinematics.stepSizeZ * (1 - f);
+                }
+                else
+                {
+                    body.X[i] = 0;
+                    body.Y[i] = 0;
+                    body.Z[i] = 0;
+                }
+            }
+        }
+
+
+
+        /**
+         * @fn  private static double smooth(double f)
+         *
+         * @brief   Smoothstep (starts and ends without velocity)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   f   The fraction of the step (0 - 1).
+         *
+         * @return  The smoothed fraction.
+         */
+
+        private static double smooth(double f)
+        {
+            return f * f * (3 - 2 * f);
+        }
+
+        #endregion FUNCTIONS
+    }
+}
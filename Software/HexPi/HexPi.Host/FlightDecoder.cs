@@ -0,0 +1,199 @@
+﻿/**********************************************************************************************//**
+ * @file    FlightDecoder.cs
+ *
+ * @brief   Implements the flight decoder class.
+ **************************************************************************************************/
+
+using System;
+using System.Globalization;
+using System.IO;
+using System.Text;
+
+namespace HexPi
+{
+
+    /**
+     * @class   FlightDecoder
+     *
+     * @brief   Exports the file of the flight recorder as CSV, one line per tick from the oldest to the newest.
+     *          Times are in milliseconds since the first tick in the file, the input and IMU timestamps as their age
+     *          at the start of the tick (empty if unknown). The file can be read while it is recorded.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    static class FlightDecoder
+    {
+        #region FUNCTIONS
+
+        /**
+         * @fn  public static bool export(string path, TextWriter csv)
+         *
+         * @brief   Exports a recording
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   path    The file of the flight recorder.
+         * @param   csv     Receives the lines.
+         *
+         * @return  True if the file was exported, false if it is no recording.
+         */
+
+        public static bool export(string path, TextWriter csv)
+        {
+            //unbuffered, the sequence number of a record is read again from the file
+            using (FileStream stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite, 1))
+            using (BinaryReader reader = new BinaryReader(stream))
+            {
+                if (stream.Length < FlightRecorder.HeaderSize || reader.ReadInt32() != FlightRecorder.Magic)
+                {
+                    Console.Error.WriteLine("Error: {0} is no flight recording!", path);
+                    return false;
+                }
+                int version = reader.ReadInt32();
+                int recordSize = reader.ReadInt32();
+                int capacity = reader.ReadInt32();
+                double frequency = reader.ReadInt64();
+                long last = reader.ReadInt64();
+                if (version != FlightRecorder.Version || recordSize != FlightRecorder.RecordSize || capacity <= 0)
+                {
+                    Console.Error.WriteLine("Error: {0} has version {1} (record {2} bytes), expected {3} ({4} bytes)!",
+                        path, version, recordSize, FlightRecorder.Version, FlightRecorder.RecordSize);
+                    return false;
+                }
+
+                csv.WriteLine(header());
+                StringBuilder line = new StringBuilder();
+                byte[] record = new byte[recordSize];
+                BinaryReader fields = new BinaryReader(new MemoryStream(record));
+                long origin = 0;
+                for (long s = Math.Max(1, last - capacity + 1); s <= last; s++)
+                {
+                    long position = FlightRecorder.HeaderSize + (s - 1) % capacity * recordSize;
+                    stream.Seek(position, SeekOrigin.Begin);
+                    if (reader.Read(record, 0, recordSize) != recordSize)
+                    {
+                        break;
+                    }
+                    //seqlock: overwritten while reading if the sequence number changed (0 while it is written)
+                    stream.Seek(position, SeekOrigin.Begin);
+                    if (BitConverter.ToInt64(record, 0) != s || reader.ReadInt64() != s)
+                    {
+                        continue;
+                    }
+
+                    fields.BaseStream.Position = sizeof(long);
+                    long start = fields.ReadInt64();
+                    long input = fields.ReadInt64();
+                    long imu = fields.ReadInt64();
+                    if (origin == 0)
+                    {
+                        origin = start;
+                    }
+
+                    line.Clear();
+                    line.Append(s);
+                    append(line, (start - origin) * 1000 / frequency);
+                    appendAge(line, start, input, frequency);
+                    appendAge(line, start, imu, frequency);
+                    line.Append(',').Append(((Controller.directions)fields.ReadByte()).ToString().ToLower());
+                    line.Append(',').Append(((Controller.modes)fields.ReadByte()).ToString().ToLower());
+                    line.Append(',').Append(fields.ReadByte());
+                    fields.ReadByte();
+                    //command, IMU, balance, tcp of each leg, time of each stage
+                    for (int i = 0; i < 9 + 4 + 2 + 3 * FlightRecorder.Legs + FlightRecorder.Stages; i++)
+                    {
+                        append(line, fields.ReadSingle());
+                    }
+                    for (int i = 0; i < FlightRecorder.Legs; i++)
+                    {
+                        line.Append(',').Append(BitConverter.ToString(fields.ReadBytes(FlightRecorder.FrameSize)).Replace('-', ' '));
+                    }
+                    csv.WriteLine(line);
+                }
+            }
+            return true;
+        }
+
+
+
+        /**
+         * @fn  private static string header()
+         *
+         * @brief   Gets the names of the columns
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The first line.
+         */
+
+        private static string header()
+        {
+            StringBuilder h = new StringBuilder("tick,time_ms,input_age_ms,imu_age_ms,direction,mode,transition,"
+                + "x,y,r,yaw,pitch,roll,a,b,c,imu_pitch,imu_roll,imu_pitch_rate,imu_roll_rate,balance_pitch,balance_roll");
+            for (int i = 0; i < FlightRecorder.Legs; i++)
+            {
+                h.AppendFormat(",leg{0}_x,leg{0}_y,leg{0}_z", i);
+            }
+            foreach (TickPipeline.stages stage in Enum.GetValues(typeof(TickPipeline.stages)))
+            {
+                h.AppendFormat(",{0}_us", stage.ToString().ToLower());
+            }
+            for (int i = 0; i < FlightRecorder.Legs; i++)
+            {
+                h.AppendFormat(",leg{0}_frame", i);
+            }
+            return h.ToString();
+        }
+
+
+
+        /**
+         * @fn  private static void append(StringBuilder line, double value)
+         *
+         * @brief   Appends a number
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   line    The line.
+         * @param   value   The value.
+         */
+
+        private static void append(StringBuilder line, double value)
+        {
+            line.Append(',').Append(value.ToString("0.####", CultureInfo.InvariantCulture));
+        }
+
+
+
+        /**
+         * @fn  private static void appendAge(StringBuilder line, long start, long timestamp, double frequency)
+         *
+         * @brief   Appends the age of a timestamp at the start of the tick (nothing if unknown)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   line        The line.
+         * @param   start       The start of the tick.
+         * @param   timestamp   The timestamp (0 = unknown).
+         * @param   frequency   The frequency of the stopwatch.
+         */
+
+        private static void appendAge(StringBuilder line, long start, long timestamp, double frequency)
+        {
+            if (timestamp == 0)
+            {
+                line.Append(',');
+                return;
+            }
+            append(line, (start - timestamp) * 1000 / frequency);
+        }
+
+        #endregion FUNCTIONS
+    }
+}
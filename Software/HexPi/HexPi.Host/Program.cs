@@ -0,0 +1,535 @@
+﻿/**********************************************************************************************//**
+ * @file    Program.cs
+ *
+ * @brief   Implements the headless host.
+ **************************************************************************************************/
+
+using System;
+using System.Diagnostics;
+using System.Threading;
+
+namespace HexPi
+{
+
+    /**
+     * @class   Program
+     *
+     * @brief   Drives the robot without WinRT (simulated legs, accelerometer and gamepad).
+     *          Usage: HexPi.Host [--ticks n] [--direction xy|turn|rotate|pose] [--mode default|terrain|balance|fast|superfast]
+     *                            [--realtime] [--fixed-rate] [--record] [--pipelined] [--bus-speed hz]
+     *                            [--bench] [--period us] [--stages] [--sense-time us] [--tilt pitch,roll] [--gains kp,ki,kd]
+     *                            [--metrics] [--metrics-port port] [--trace] [--flight file] [--decode file]
+     *                            [--replay trace] [--runs n] [--expect checksum]
+     *          Without --realtime the ticks run back to back, otherwise the input task of the controller
+     *          runs at its fixed rate. --bench compares the latency of the ticks with and without the bus thread
+     *          on a simulated bus (default 400kHz) at a fixed period. --stages prints the time of each stage of a tick
+     *          and the latency from the input reading to its end.
+     *          --sense-time sets the time a simulated leg needs per 2mm while it senses the ground.
+     *          --tilt sets the simulated accelerometer (rad) and prints the output of the balance controller,
+     *          --gains sets its constants. --metrics prints the metrics (Prometheus text) at the end,
+     *          --metrics-port serves them on localhost while the robot runs. --trace enables the per-tick events of
+     *          TickEventSource in the process and prints the mean time of each stage and section.
+     *          --flight records every tick with the flight recorder, --decode prints a recording as CSV and exits.
+     *          --replay replays a gamepad trace --runs times (default 5) as fast as possible and prints the rate,
+     *          the allocations and the checksum of the frames (see ReplayBench, e.g. session.trace),
+     *          --expect fails if the checksum differs.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    static class Program
+    {
+
+        /**
+         * @fn  static int Main(string[] args)
+         *
+         * @brief   Main entry-point
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   args    The command line arguments.
+         *
+         * @return  Exit-code for the process - 0 for success, else an error code.
+         */
+
+        static int Main(string[] args)
+        {
+            long ticks = 400;
+            string direction = "xy";
+            string mode = "default";
+            bool realtime = false;
+            bool record = false;
+            bool adaptive = true;
+            bool pipelined = false;
+            bool bench = false;
+            int busSpeed = 0;
+            long period = 5000;
+            bool stages = false;
+            long senseTime = 0;
+            double[] tilt = null;
+            double[] gains = null;
+            bool metrics = false;
+            int metricsPort = 0;
+            TickProfiler profiler = null;
+            string flight = null;
+            string replay = null;
+            int runs = 5;
+            string expect = null;
+
+            for (int i = 0; i < args.Length; i++)
+            {
+                switch (args[i])
+                {
+                    case "--ticks":
+                        ticks = long.Parse(args[++i]);
+                        break;
+                    case "--direction":
+                        direction = args[++i];
+                        break;
+                    case "--mode":
+                        mode = args[++i];
+                        break;
+                    case "--realtime":
+                        realtime = true;
+                        break;
+                    case "--record":
+                        record = true;
+                        break;
+                    case "--fixed-rate":
+                        adaptive = false;
+                        break;
+                    case "--pipelined":
+                        pipelined = true;
+                        break;
+                    case "--bus-speed":
+                        busSpeed = int.Parse(args[++i]);
+                        break;
+                    case "--bench":
+                        bench = true;
+                        break;
+                    case "--period":
+                        period = long.Parse(args[++i]);
+                        break;
+                    case "--stages":
+                        stages = true;
+                        break;
+                    case "--sense-time":
+                        senseTime = long.Parse(args[++i]);
+                        break;
+                    case "--tilt":
+                        tilt = parseList(args[++i], 2);
+                        break;
+                    case "--gains":
+                        gains = parseList(args[++i], 3);
+                        break;
+                    case "--metrics":
+                        metrics = true;
+                        break;
+                    case "--metrics-port":
+                        metricsPort = int.Parse(args[++i]);
+                        break;
+                    case "--trace":
+                        profiler = new TickProfiler();
+                        break;
+                    case "--flight":
+                        flight = args[++i];
+                        break;
+                    case "--decode":
+                        return FlightDecoder.export(args[++i], Console.Out) ? 0 : 1;
+                    case "--replay":
+                        replay = args[++i];
+                        break;
+                    case "--runs":
+                        runs = int.Parse(args[++i]);
+                        break;
+                    case "--expect":
+                        expect = args[++i];
+                        break;
+                    default:
+                        Console.Error.WriteLine("Usage: HexPi.Host [--ticks n] [--direction xy|turn|rotate|pose] [--mode default|terrain|balance|fast|superfast] [--realtime] [--fixed-rate] [--record] [--pipelined] [--bus-speed hz] [--bench] [--period us] [--stages] [--sense-time us] [--tilt pitch,roll] [--gains kp,ki,kd] [--metrics] [--metrics-port port] [--trace] [--flight file] [--decode file] [--replay trace] [--runs n] [--expect checksum]");
+                        return 1;
+                }
+            }
+
+            if (bench)
+            {
+                int speed = busSpeed > 0 ? busSpeed : 400000;
+                benchPipeline(false, ticks, period, speed, direction, mode);
+                benchPipeline(true, ticks, period, speed, direction, mode);
+                return 0;
+            }
+
+            if (replay != null)
+            {
+                return ReplayBench.run(replay, Math.Max(1, runs), expect);
+            }
+
+            SimulatedBackend legs = new SimulatedBackend();
+            legs.BusSpeed = busSpeed;
+            legs.SenseTime = senseTime;
+            RecordingBackend recorder = record ? new RecordingBackend(legs) : null;
+            SimulatedImu imu = new SimulatedImu();
+            SimulatedInput input = new SimulatedInput();
+
+            Controller control = new Controller(input, imu, record ? (IActuatorBackend)recorder : legs);
+            control.ShutdownRequested = () => Console.WriteLine("Info: Shutdown requested.");
+            control.Adaptive = adaptive;
+            control.Pipelined = pipelined;
+            control.MetricsPort = metricsPort;
+            control.RecorderPath = flight;
+            control.init();
+            FlightRecorder flightRecorder = control.Recorder;
+            if (tilt != null)
+            {
+                imu.Pitch = tilt[0];
+                imu.Roll = tilt[1];
+            }
+            if (gains != null)
+            {
+                control.Balance.Kp = gains[0];
+                control.Balance.Ki = gains[1];
+                control.Balance.Kd = gains[2];
+            }
+            select(control, input, direction, mode);
+            control.Stages.resetStatistics();
+            control.Memory.resetStatistics();
+            control.Metrics.resetStatistics();
+
+            Stopwatch time = Stopwatch.StartNew();
+            if (realtime)
+            {
+                control.Scheduler.resetStatistics();
+                control.start();
+                while (control.Scheduler.getStatistics().Ticks < ticks)
+                {
+                    Thread.Sleep(1);
+                }
+                control.stop();
+                ticks = control.Scheduler.getStatistics().Ticks;
+            }
+            else
+            {
+                for (long i = 0; i < ticks; i++)
+                {
+                    control.tick();
+                }
+            }
+            time.Stop();
+
+            Console.WriteLine("ticks: {0}  time: {1:F1}ms  rate: {2:F0} ticks/s  imu reads: {3}",
+                ticks, time.Elapsed.TotalMilliseconds, ticks / time.Elapsed.TotalSeconds, imu.Reads);
+            GcMonitor.Statistics gc = control.Memory.getStatistics();
+            Console.WriteLine("gc: gen0 {0}  gen1 {1}  gen2 {2}  pause {3:F1}ms  allocated {4} bytes ({5:F1} per tick)",
+                gc.Gen0, gc.Gen1, gc.Gen2, gc.PauseTime, gc.Allocated, (double)gc.Allocated / ticks);
+            for (int i = 0; i < legs.Legs.Length; i++)
+            {
+                SimulatedLeg l = legs.Legs[i];
+                Console.WriteLine("leg {0}: gamma {1,4}  beta {2,4}  alpha {3,4}  z {4,4}", i, l.Gamma, l.Beta, l.Alpha, l.ZPos);
+            }
+            if (realtime)
+            {
+                TickScheduler.Statistics stats = control.Scheduler.getStatistics();
+                Console.WriteLine("period: {0:F0}us  overruns: {1}  skipped: {2}  jitter: {3:F0}/{4:F0}/{5:F0}us (min/mean/max) sd {6:F0}us  tick: {7:F0}/{8:F0}us (mean/max)  spin: {9:F0}us",
+                    stats.Period, stats.Overruns, stats.Skipped, stats.JitterMin, stats.JitterMean, stats.JitterMax, stats.JitterStdDev,
+                    stats.DurationMean, stats.DurationMax, stats.Spin);
+                AdaptiveRate.Estimate e = control.Rate.getEstimate(rateMode(mode));
+                Console.WriteLine("bus: {0:F0}us  tick: {1:F0}us +- {2:F0}us  load: {3:F0}%",
+                    e.BusTime, e.TickTime, e.Deviation, 100 * e.BusTime / stats.Period);
+            }
+            if (stages)
+            {
+                foreach (TickPipeline.stages stage in Enum.GetValues(typeof(TickPipeline.stages)))
+                {
+                    TickPipeline.Statistics s = control.Stages.getStatistics(stage);
+                    LatencyHistogram.Summary l = control.Stages.getLatency(stage);
+                    Console.WriteLine("stage {0,-9} mean {1,7:F2}us  max {2,8:F1}us  latency {3,5:F0}/{4,5:F0}/{5,6:F0}us (p50/p99/max)",
+                        stage.ToString().ToLower(), s.Mean, s.Max, l.P50, l.P99, l.Max);
+                }
+            }
+            if (tilt != null)
+            {
+                Console.WriteLine("balance: pitch {0:F4}  roll {1:F4}  step {2:F4}s",
+                    control.Balance.Pitch, control.Balance.Roll, control.Balance.Step);
+            }
+            if (metrics)
+            {
+                control.writeMetrics(Console.Out);
+            }
+            if (profiler != null)
+            {
+                profiler.print();
+                profiler.Dispose();
+            }
+            if (recorder != null)
+            {
+                Console.WriteLine("recorded frames: {0}", recorder.Frames.Count);
+            }
+            if (flightRecorder != null)
+            {
+                //closes the flight recorder
+                control.stop();
+                Console.WriteLine("flight recorder: {0} ticks ({1} kept) in {2}",
+                    flightRecorder.Count, Math.Min(flightRecorder.Count, flightRecorder.Capacity), flight);
+            }
+            return 0;
+        }
+
+
+
+        /**
+         * @fn  private static double[] parseList(string value, int count)
+         *
+         * @brief   Parses a comma separated list of numbers
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   value   The list.
+         * @param   count   The number of values.
+         *
+         * @return  The values.
+         */
+
+        private static double[] parseList(string value, int count)
+        {
+            string[] parts = value.Split(',');
+            if (parts.Length != count)
+            {
+                throw new FormatException(string.Format("Expected {0} values: {1}", count, value));
+            }
+
+            double[] values = new double[count];
+            for (int i = 0; i < count; i++)
+            {
+                values[i] = double.Parse(parts[i], System.Globalization.CultureInfo.InvariantCulture);
+            }
+            return values;
+        }
+
+
+
+        /**
+         * @fn  private static void benchPipeline(bool pipelined, long ticks, long period, int busSpeed, string direction, string mode)
+         *
+         * @brief   Runs the ticks at a fixed period on a simulated bus and prints the latency of the control thread
+         *          per tick (p50/p99/max) and, with the bus thread, the time until the last frame of a tick was sent.
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   pipelined   True to send the frames on the bus thread.
+         * @param   ticks       The number of ticks.
+         * @param   period      The period in microseconds.
+         * @param   busSpeed    The simulated bus speed in Hz.
+         * @param   direction   The direction.
+         * @param   mode        The mode.
+         */
+
+        private static void benchPipeline(bool pipelined, long ticks, long period, int busSpeed, string direction, string mode)
+        {
+            SimulatedBackend legs = new SimulatedBackend();
+            legs.BusSpeed = busSpeed;
+            SimulatedInput input = new SimulatedInput();
+
+            Controller control = new Controller(input, new SimulatedImu(), legs);
+            control.Adaptive = false;
+            control.Pipelined = pipelined;
+            control.init();
+            select(control, input, direction, mode);
+            if (control.Pipeline != null)
+            {
+                control.Pipeline.drain();
+            }
+
+            long[] latency = new long[ticks];
+            long n = 0;
+            TickScheduler scheduler = new TickScheduler(period);
+            scheduler.run(() =>
+            {
+                long start = Stopwatch.GetTimestamp();
+                control.tick();
+                latency[n] = Stopwatch.GetTimestamp() - start;
+                if (++n == ticks)
+                {
+                    scheduler.stop();
+                }
+            });
+            if (control.Pipeline != null)
+            {
+                control.Pipeline.drain();
+            }
+
+            Array.Sort(latency);
+            double us = 1000000.0 / Stopwatch.Frequency;
+            TickScheduler.Statistics stats = scheduler.getStatistics();
+            Console.WriteLine("{0,-10} bus {1}kHz period {2}us: tick p50 {3:F0}us  p99 {4:F0}us  max {5:F0}us  overruns {6}",
+                pipelined ? "pipelined" : "direct", busSpeed / 1000, period,
+                latency[ticks / 2] * us, latency[ticks * 99 / 100] * us, latency[ticks - 1] * us, stats.Overruns);
+            if (control.Pipeline != null)
+            {
+                PipelinedBackend.Statistics p = control.Pipeline.getStatistics();
+                Console.WriteLine("{0,-10} sent after tick: mean {1:F0}us  max {2:F0}us  frames {3}  max queued {4}  stalls {5}  drains {6}",
+                    "", p.Latency, p.LatencyMax, p.Frames, p.MaxDepth, p.Stalls, p.Drains);
+            }
+            control.stop();
+        }
+
+
+
+        /**
+         * @fn  private static void select(Controller control, SimulatedInput input, string direction, string mode)
+         *
+         * @brief   Selects the direction with the dpad (one tick), then holds the mode button and the sticks
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   control     The controller.
+         * @param   input       The simulated gamepad.
+         * @param   direction   The direction.
+         * @param   mode        The mode.
+         */
+
+        private static void select(Controller control, SimulatedInput input, string direction, string mode)
+        {
+            InputState state = new InputState();
+            state.Buttons = directionButton(direction);
+            input.State = state;
+            control.tick();
+
+            state = sticks(direction);
+            state.Buttons = modeButton(mode);
+            input.State = state;
+        }
+
+
+
+        /**
+         * @fn  private static Controller.buttons directionButton(string direction)
+         *
+         * @brief   Gets the dpad button that selects a direction
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   direction   The direction (xy, turn, rotate or pose).
+         *
+         * @return  The button.
+         */
+
+        private static Controller.buttons directionButton(string direction)
+        {
+            switch (direction)
+            {
+                case "turn":
+                    return Controller.buttons.DPADRIGHT;
+                case "rotate":
+                    return Controller.buttons.DPADDOWN;
+                case "pose":
+                    return Controller.buttons.DPADLEFT;
+                default:
+                    return Controller.buttons.DPADUP;
+            }
+        }
+
+
+
+        /**
+         * @fn  private static Controller.buttons modeButton(string mode)
+         *
+         * @brief   Gets the button that selects a mode
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   mode    The mode (default, terrain or balance).
+         *
+         * @return  The button.
+         */
+
+        private static Controller.buttons modeButton(string mode)
+        {
+            switch (mode)
+            {
+                case "terrain":
+                    return Controller.buttons.LEFTSHOULDER;
+                case "balance":
+                    return Controller.buttons.RIGHTSHOULDER;
+                case "fast":
+                    return Controller.buttons.RIGHTTHUMBSTICK;
+                case "superfast":
+                    return Controller.buttons.LEFTTHUMBSTICK | Controller.buttons.RIGHTTHUMBSTICK;
+                default:
+                    return Controller.buttons.NONE;
+            }
+        }
+
+
+
+        /**
+         * @fn  private static byte rateMode(string mode)
+         *
+         * @brief   Gets the mode whose bus load is measured
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   mode    The mode (default, terrain, balance, fast or superfast).
+         *
+         * @return  The measured mode.
+         */
+
+        private static byte rateMode(string mode)
+        {
+            switch (mode)
+            {
+                case "terrain":
+                    return (byte)Controller.modes.TERRAIN;
+                case "balance":
+                    return (byte)Controller.modes.BALANCE;
+                default:
+                    return (byte)Controller.modes.DEFAULT;
+            }
+        }
+
+
+
+        /**
+         * @fn  private static InputState sticks(string direction)
+         *
+         * @brief   Gets a stick position that moves the robot in a direction
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   direction   The direction (xy, turn, rotate or pose).
+         *
+         * @return  The reading.
+         */
+
+        private static InputState sticks(string direction)
+        {
+            InputState state = new InputState();
+            switch (direction)
+            {
+                case "turn":
+                    state.LeftThumbstickY = -1;
+                    state.RightThumbstickX = 0.5;
+                    break;
+                case "rotate":
+                    state.LeftThumbstickX = 1;
+                    break;
+                case "pose":
+                    state.LeftThumbstickX = 0.5;
+                    state.RightThumbstickY = 0.5;
+                    break;
+                default:
+                    state.LeftThumbstickY = -1;
+                    break;
+            }
+            return state;
+        }
+    }
+}
@@ -0,0 +1,303 @@
+﻿/**********************************************************************************************//**
+ * @file    ReplayBench.cs
+ *
+ * @brief   Implements the replay bench class.
+ **************************************************************************************************/
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
+using System.IO;
+
+namespace HexPi
+{
+
+    /**
+     * @class   ReplayBench
+     *
+     * @brief   Replays a recorded gamepad session through the controller against simulated legs, as fast as possible.
+     *          Prints the ticks per second, the allocations and a checksum of every frame sent to the legs.
+     *          The checksum does not depend on the speed (fixed rate, the IMU stays level), so it shows whether a
+     *          change of Controller, Hexapod or Leg changed the motion.
+     *
+     *          Trace: one line per reading, held for a number of ticks (# starts a comment).
+     *          ticks buttons left-x left-y right-x right-y left-trigger right-trigger
+     *          The buttons are NONE or names of Controller.buttons joined with +, e.g. "20 DPADUP 0 0 0 0 0 0".
+     *          The dpad selects the direction, the shoulder and thumbstick buttons the mode (see Controller.tick()).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    static class ReplayBench
+    {
+
+        /**
+         * @class   ChecksumBackend
+         *
+         * @brief   Hashes every frame written to the legs (FNV-1a over the position of the leg and the frame)
+         *          and passes it on to another backend.
+         */
+
+        private class ChecksumBackend : IActuatorBackend
+        {
+
+            /**
+             * @class   Bus
+             *
+             * @brief   The hashing bus of one leg.
+             */
+
+            private class Bus : ILegBus
+            {
+                /** @brief   The backend. */
+                ChecksumBackend backend;
+                /** @brief   The bus of the leg in the inner backend. */
+                ILegBus inner;
+                /** @brief   The position of the leg. */
+                int index;
+
+                public Bus(ChecksumBackend backend, ILegBus inner, int index)
+                {
+                    this.backend = backend;
+                    this.inner = inner;
+                    this.index = index;
+                }
+
+                public bool write(byte[] data)
+                {
+                    backend.add(index, data);
+                    return inner.write(data);
+                }
+
+                public bool read(byte[] data)
+                {
+                    return inner.read(data);
+                }
+            }
+
+            /** @brief   The backend receiving the frames. */
+            IActuatorBackend inner;
+
+            /** @brief   The FNV-1a prime. */
+            private const ulong prime = 1099511628211;
+
+            public ChecksumBackend(IActuatorBackend inner)
+            {
+                this.inner = inner;
+            }
+
+            /** @brief   The hash of all frames. */
+            public ulong Checksum { get; private set; } = 14695981039346656037;
+
+            /** @brief   The number of frames. */
+            public long Frames { get; private set; }
+
+            public bool Calibrated => inner.Calibrated;
+
+            public long FramePeriod => inner.FramePeriod;
+
+            public ILegBus open(byte address, int index)
+            {
+                return new Bus(this, inner.open(address, index), index);
+            }
+
+            public void flush()
+            {
+                inner.flush();
+            }
+
+            private void add(int index, byte[] data)
+            {
+                ulong h = (Checksum ^ (ulong)index) * prime;
+                for (int i = 0; i < data.Length; i++)
+                {
+                    h = (h ^ data[i]) * prime;
+                }
+                Checksum = h;
+                Frames++;
+            }
+        }
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public static int run(string path, int runs, string expect)
+         *
+         * @brief   Replays a trace several times and prints each run and the median rate
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   path    The trace.
+         * @param   runs    The number of runs (the first one includes the JIT).
+         * @param   expect  The expected checksum (hex) or null.
+         *
+         * @return  0 if the checksum was the same in every run (and as expected), 1 otherwise.
+         */
+
+        public static int run(string path, int runs, string expect)
+        {
+            long[] ticks;
+            InputState[] states;
+            if (!load(path, out ticks, out states))
+            {
+                return 1;
+            }
+
+            double[] rates = new double[runs];
+            ulong checksum = 0;
+            bool stable = true;
+            for (int r = 0; r < runs; r++)
+            {
+                SimulatedBackend legs = new SimulatedBackend();
+                ChecksumBackend output = new ChecksumBackend(legs);
+                SimulatedInput input = new SimulatedInput();
+
+                Controller control = new Controller(input, new SimulatedImu(), output);
+                control.ShutdownRequested = () => { };
+                //fixed timeframe of each mode, independent of the measured bus time
+                control.Adaptive = false;
+                control.init();
+                control.Memory.resetStatistics();
+
+                long count = 0;
+                Stopwatch time = Stopwatch.StartNew();
+                for (int s = 0; s < states.Length; s++)
+                {
+                    input.State = states[s];
+                    for (long i = 0; i < ticks[s]; i++)
+                    {
+                        control.tick();
+                    }
+                    count += ticks[s];
+                }
+                time.Stop();
+
+                GcMonitor.Statistics gc = control.Memory.getStatistics();
+                rates[r] = count / time.Elapsed.TotalSeconds;
+                Console.WriteLine("replay {0}: ticks {1}  time {2:F1}ms  rate {3:F0} ticks/s  allocated {4} bytes  gen0 {5}  frames {6}  checksum {7:X16}",
+                    r + 1, count, time.Elapsed.TotalMilliseconds, rates[r], gc.Allocated, gc.Gen0, output.Frames, output.Checksum);
+
+                if (r > 0 && output.Checksum != checksum)
+                {
+                    stable = false;
+                }
+                checksum = output.Checksum;
+            }
+
+            Array.Sort(rates);
+            Console.WriteLine("replay: median {0:F0} ticks/s  best {1:F0} ticks/s  checksum {2:X16}{3}",
+                rates[runs / 2], rates[runs - 1], checksum, stable ? "" : " (differs between runs)");
+
+            if (expect != null && !string.Equals(expect, checksum.ToString("X16"), StringComparison.OrdinalIgnoreCase))
+            {
+                Console.Error.WriteLine("Error: Checksum {0:X16} differs from the expected {1}!", checksum, expect);
+                return 1;
+            }
+            return stable ? 0 : 1;
+        }
+
+
+
+        /**
+         * @fn  private static bool load(string path, out long[] ticks, out InputState[] states)
+         *
+         * @brief   Reads a trace
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   path            The trace.
+         * @param [out] ticks       The number of ticks of each reading.
+         * @param [out] states      The readings.
+         *
+         * @return  False if the trace is invalid.
+         */
+
+        private static bool load(string path, out long[] ticks, out InputState[] states)
+        {
+            List<long> t = new List<long>();
+            List<InputState> s = new List<InputState>();
+            int number = 0;
+            foreach (string line in File.ReadLines(path))
+            {
+                number++;
+                string text = line;
+                int comment = text.IndexOf('#');
+                if (comment >= 0)
+                {
+                    text = text.Substring(0, comment);
+                }
+                string[] parts = text.Split(new char[] { ' ', '\t' }, StringSplitOptions.RemoveEmptyEntries);
+                if (parts.Length == 0)
+                {
+                    continue;
+                }
+
+                InputState state = new InputState();
+                long n;
+                double[] axes = new double[6];
+                bool ok = parts.Length == 8 && long.TryParse(parts[0], out n) && n >= 0 && parseButtons(parts[1], out state.Buttons);
+                for (int i = 0; ok && i < axes.Length; i++)
+                {
+                    ok = double.TryParse(parts[i + 2], NumberStyles.Float, CultureInfo.InvariantCulture, out axes[i]);
+                }
+                if (!ok)
+                {
+                    Console.Error.WriteLine("Error: {0}({1}): expected \"ticks buttons lx ly rx ry lt rt\"!", path, number);
+                    ticks = null;
+                    states = null;
+                    return false;
+                }
+
+                state.LeftThumbstickX = axes[0];
+                state.LeftThumbstickY = axes[1];
+                state.RightThumbstickX = axes[2];
+                state.RightThumbstickY = axes[3];
+                state.LeftTrigger = axes[4];
+                state.RightTrigger = axes[5];
+                t.Add(long.Parse(parts[0]));
+                s.Add(state);
+            }
+
+            ticks = t.ToArray();
+            states = s.ToArray();
+            return true;
+        }
+
+
+
+        /**
+         * @fn  private static bool parseButtons(string text, out Controller.buttons buttons)
+         *
+         * @brief   Parses the buttons of a reading
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   text            NONE or the names of the buttons joined with +.
+         * @param [out] buttons     The buttons.
+         *
+         * @return  False if a name is unknown.
+         */
+
+        private static bool parseButtons(string text, out Controller.buttons buttons)
+        {
+            buttons = Controller.buttons.NONE;
+            foreach (string name in text.Split('+'))
+            {
+                Controller.buttons b;
+                if (!Enum.TryParse(name, true, out b) || !Enum.IsDefined(typeof(Controller.buttons), b))
+                {
+                    return false;
+                }
+                buttons |= b;
+            }
+            return true;
+        }
+
+        #endregion FUNCTIONS
+    }
+}
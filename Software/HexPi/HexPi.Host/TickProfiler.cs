@@ -0,0 +1,132 @@
+﻿/**********************************************************************************************//**
+ * @file    TickProfiler.cs
+ *
+ * @brief   Implements the tick profiler class.
+ **************************************************************************************************/
+
+using System;
+using System.Diagnostics.Tracing;
+
+namespace HexPi
+{
+
+    /**
+     * @class   TickProfiler
+     *
+     * @brief   Listens to the events of TickEventSource in the process (full per-tick tracing)
+     *          and sums the time of each stage and section.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    sealed class TickProfiler : EventListener
+    {
+        #region Objects
+        /** @brief   Lock for the sums. */
+        object sumLock = new object();
+        #endregion Objects
+
+        #region Arrays
+        /** @brief   The number of events of each stage. */
+        long[] stageCount = new long[Enum.GetValues(typeof(TickPipeline.stages)).Length];
+
+        /** @brief   The time of each stage in nanoseconds. */
+        long[] stageSum = new long[Enum.GetValues(typeof(TickPipeline.stages)).Length];
+
+        /** @brief   The number of events of each section. */
+        long[] sectionCount = new long[Enum.GetValues(typeof(TickEventSource.sections)).Length];
+
+        /** @brief   The time of each section in nanoseconds. */
+        long[] sectionSum = new long[Enum.GetValues(typeof(TickEventSource.sections)).Length];
+        #endregion Arrays
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public void print()
+         *
+         * @brief   Prints the mean time of each stage and section
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void print()
+        {
+            lock (sumLock)
+            {
+                for (int i = 0; i < stageCount.Length; i++)
+                {
+                    Console.WriteLine("trace stage   {0,-9} events {1,6}  mean {2,8:F2}us", ((TickPipeline.stages)i).ToString().ToLower(),
+                        stageCount[i], stageCount[i] > 0 ? stageSum[i] / 1000.0 / stageCount[i] : 0);
+                }
+                for (int i = 0; i < sectionCount.Length; i++)
+                {
+                    Console.WriteLine("trace section {0,-9} events {1,6}  mean {2,8:F2}us", ((TickEventSource.sections)i).ToString().ToLower(),
+                        sectionCount[i], sectionCount[i] > 0 ? sectionSum[i] / 1000.0 / sectionCount[i] : 0);
+                }
+            }
+        }
+
+
+
+        /**
+         * @fn  protected override void OnEventSourceCreated(EventSource source)
+         *
+         * @brief   Enables all events of the tick source
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   source  The event source.
+         */
+
+        protected override void OnEventSourceCreated(EventSource source)
+        {
+            if (source.Name == "HexPi-Tick")
+            {
+                EnableEvents(source, EventLevel.Verbose, TickEventSource.Keywords.Stages | TickEventSource.Keywords.Sections);
+            }
+        }
+
+
+
+        /**
+         * @fn  protected override void OnEventWritten(EventWrittenEventArgs e)
+         *
+         * @brief   Adds the time of a stage or section
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   e   The event.
+         */
+
+        protected override void OnEventWritten(EventWrittenEventArgs e)
+        {
+            if (e.Payload == null || e.Payload.Count != 2)
+            {
+                return;
+            }
+
+            int index = (int)e.Payload[0];
+            int duration = (int)e.Payload[1];
+            lock (sumLock)
+            {
+                if (e.EventId == 1 && index < stageCount.Length)
+                {
+                    stageCount[index]++;
+                    stageSum[index] += duration;
+                }
+                else if (e.EventId == 2 && index < sectionCount.Length)
+                {
+                    sectionCount[index]++;
+                    sectionSum[index] += duration;
+                }
+            }
+        }
+
+        #endregion FUNCTIONS
+    }
+}
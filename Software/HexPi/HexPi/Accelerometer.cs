@@ -9,6 +9,7 @@ using System.Collections.Generic;
 using System.Diagnostics;
 using System.Linq;
 using System.Text;
+using System.Threading;
 using System.Threading.Tasks;
 using Windows.Devices.Enumeration;
 using Windows.Devices.I2c;
@@ -19,47 +20,118 @@ namespace HexPi
     /**
      * @class   Accelerometer
      *
-     * @brief   An accelerometer.
+     * @brief   An accelerometer and gyroscope (LSM6DS33).
+     *          The sensor writes both into its FIFO, a background thread drains the FIFO with one burst
+     *          read every few milliseconds and fuses every sample (complementary filter): the angles follow
+     *          the gyroscope without lag, the accelerometer slowly pulls them to the direction of gravity.
+     *          read() only takes the latest attitude, so the control tick never waits for the bus.
      *
      * @author  Alex
      * @date    13.08.2017
      */
 
-    class Accelerometer
+    class Accelerometer : IImu
     {
         #region Objects
 
         /** @brief   The I2C device. */
         I2cDevice device = null;
 
+        /** @brief   The latest attitude (written by the sampler). */
+        SampleSlot<ImuSample> latest = new SampleSlot<ImuSample>();
+
+        /** @brief   The sampler thread. */
+        Task sampler = null;
+
+        /** @brief   Never set, waits between the reads. */
+        ManualResetEvent pause = new ManualResetEvent(false);
+
         #endregion Objects
 
         #region Fields
 
-        /** @brief   The x coordinate. */
-        private double x = 0.0;
+        /** @brief   The attitude taken by the last read(). */
+        private ImuSample current;
+
+        /** @brief   The fused pitch in rad (sampler only). */
+        private double pitch = 0.0;
+
+        /** @brief   The fused roll in rad (sampler only). */
+        private double roll = 0.0;
 
-        /** @brief   The y coordinate. */
-        private double y = 0.0;
+        /** @brief   The pitch rate of the last sample in rad/s (sampler only). */
+        private double pitchRate = 0.0;
 
-        /** @brief   The z coordinate. */
-        private double z = 0.0;
+        /** @brief   The roll rate of the last sample in rad/s (sampler only). */
+        private double rollRate = 0.0;
+
+        /** @brief   True after the first sample (the filter starts at the angles of the accelerometer). */
+        private bool started = false;
+
+        /** @brief   The time of the FIFO reads since the last takeBusTime() in stopwatch ticks. */
+        private long busTime = 0;
 
         #endregion Fields
 
+        #region CONSTANTS
+        /** @brief   The address of the control register of the accelerometer. */
+        private const byte CTRL1_XL = 0x10;
+
+        /** @brief   The address of the control register of the gyroscope. */
+        private const byte CTRL2_G = 0x11;
+
+        /** @brief   The address of the FIFO control register 3 (decimation). */
+        private const byte FIFO_CTRL3 = 0x08;
+
+        /** @brief   The address of the FIFO control register 5 (rate and mode). */
+        private const byte FIFO_CTRL5 = 0x0A;
+
+        /** @brief   The address of the FIFO status register 1 (followed by status registers 2 - 4). */
+        private const byte FIFO_STATUS1 = 0x3A;
+
+        /** @brief   The address of the FIFO output (rolls back to itself during a burst read). */
+        private const byte FIFO_DATA_OUT_L = 0x3E;
+
+        /** @brief   The output data rate of both sensors in Hz. */
+        private const double rate = 208.0;
+
+        /** @brief   The gyroscope in rad/s per digit (+-245dps, 8.75mdps/digit). */
+        private const double gyroScale = 0.00875 * Math.PI / 180;
+
+        /** @brief   The accelerometer in g per digit (+-2g). */
+        private const double accelScale = 1 / 16383.0;
+
+        /** @brief   The scale of the published angles (as the accelerometer was always read). */
+        private const double angleScale = 100 * Math.PI / 180;
+
+        /** @brief   The time constant of the complementary filter in seconds (below: gyroscope, above: accelerometer). */
+        private const double timeConstant = 0.5;
+
+        /** @brief   The weight of the gyroscope in the complementary filter. */
+        private const double alpha = timeConstant / (timeConstant + 1 / rate);
+
+        /** @brief   The words of one sample in the FIFO (gyroscope x, y, z, then accelerometer x, y, z). */
+        private const int sampleWords = 6;
+
+        /** @brief   The maximum number of samples of one burst read. */
+        private const int maxSamples = 32;
+
+        /** @brief   The time between two burst reads in milliseconds. */
+        private const int interval = 10;
+        #endregion CONSTANTS
+
         #region Arrays
-        /** @brief   Array for the last 3 x-Values */
-        double[] xVal = new double[3];
-        /** @brief   Array for the last 3 y-Values */
-        double[] yVal = new double[3];
-        /** @brief   Array for the last 3 z-Values */
-        double[] zVal = new double[3];
-
-        /** @brief   Buffer for i2c-write (address of first register). */
-        byte[] writeBuffer = new byte[] { 0x28 };
-
-        /** @brief   Buffer for i2c-read. */
-        byte[] readBuffer = new byte[6];
+        /** @brief   Buffer for i2c-write (address of the FIFO status registers). */
+        byte[] statusAddress = new byte[] { FIFO_STATUS1 };
+
+        /** @brief   Buffer for i2c-read of the FIFO status registers. */
+        byte[] statusBuffer = new byte[4];
+
+        /** @brief   Buffer for i2c-write (address of the FIFO output). */
+        byte[] dataAddress = new byte[] { FIFO_DATA_OUT_L };
+
+        /** @brief   Buffers for i2c-read of the FIFO (one for each number of words). */
+        byte[][] dataBuffers = new byte[maxSamples * sampleWords + 1][];
         #endregion Arrays
 
         #region Properties
@@ -75,18 +147,7 @@ namespace HexPi
 
         public double Pitch
         {
-            get
-            {   
-                //calc pitch
-                double xz = Math.Round((Math.Acos(x / (Math.Sqrt(x * x + z * z))) - Math.PI / 2) * 100 * Math.PI / 180, 2);
-
-                //check for errors
-                if (double.IsNaN(xz) || double.IsInfinity(xz))
-                {
-                    return 0;
-                }
-                return xz;
-            }
+            get { return current.Pitch; }
         }
 
 
@@ -100,18 +161,52 @@ namespace HexPi
 
         public double Roll
         {
-            get
-            {
-                //calc roll
-                double yz = Math.Round((Math.Acos(y / (Math.Sqrt(y * y + z * z))) - Math.PI / 2) * 100 * Math.PI / 180, 2);
-                //check for errors
-                if (double.IsNaN(yz) || double.IsInfinity(yz))
-                {
-                    return 0;
-                }
+            get { return current.Roll; }
+        }
 
-                return yz;
-            }
+
+
+        /**
+         * @property    public double PitchRate
+         *
+         * @brief   Gets the pitch rate of the gyroscope
+         *
+         * @return  The pitch rate (unit of the pitch per second).
+         */
+
+        public double PitchRate
+        {
+            get { return current.PitchRate; }
+        }
+
+
+
+        /**
+         * @property    public double RollRate
+         *
+         * @brief   Gets the roll rate of the gyroscope
+         *
+         * @return  The roll rate (unit of the roll per second).
+         */
+
+        public double RollRate
+        {
+            get { return current.RollRate; }
+        }
+
+
+
+        /**
+         * @property    public long Timestamp
+         *
+         * @brief   Gets the time of the last measurement in the attitude
+         *
+         * @return  The timestamp (stopwatch ticks, 0 before the first sample).
+         */
+
+        public long Timestamp
+        {
+            get { return current.Timestamp; }
         }
         #endregion Properties
 
@@ -136,7 +231,9 @@ namespace HexPi
         /**
          * @fn  public async void init()
          *
-         * @brief   Initializes this object
+         * @brief   Initializes this object.
+         *          Sets the accelerometer (+-2g) and the gyroscope (+-245dps) to 208Hz and the FIFO to continuous
+         *          mode at the same rate (both sensors, no decimation), then starts the sampler.
          *
          * @author  Alex
          * @date    13.08.2017
@@ -147,11 +244,18 @@ namespace HexPi
             try
             {
                 I2cConnectionSettings settings = new I2cConnectionSettings(0x6B); // Address
-                settings.BusSpeed = I2cBusSpeed.StandardMode;
+                settings.BusSpeed = I2cBusSpeed.FastMode;
                 settings.SharingMode = I2cSharingMode.Shared;
                 string aqs = I2cDevice.GetDeviceSelector("I2C1");
                 DeviceInformationCollection dis = await DeviceInformation.FindAllAsync(aqs);
                 device = await I2cDevice.FromIdAsync(dis[0].Id, settings);
+
+                device.Write(new byte[] { CTRL1_XL, 0x50 });
+                device.Write(new byte[] { CTRL2_G, 0x50 });
+                device.Write(new byte[] { FIFO_CTRL3, 0x09 });
+                device.Write(new byte[] { FIFO_CTRL5, 0x2E });
+
+                sampler = Task.Factory.StartNew(sample, TaskCreationOptions.LongRunning);
             }
             catch
             {
@@ -163,15 +267,7 @@ namespace HexPi
         /**
          * @fn  public void read()
          *
-         * @brief   Read data for each axis.
-         *          1. Initialize the sensor with 0x10,0x80.  
-         *          2. Wait until the sensor has new data.  
-         *          3. Write address of the first value (address increments automaticaly after each read)  
-         *          4. Combine the 2 bytes to a 16bit value and add it to the last value  
-         *          5. Divide the sum with number of measurements  
-         *          6. Save last value in xVal-Array  
-         *          7. Calculate x by using a weighted average (20% , 50% , 25%)
-         *          
+         * @brief   Takes the latest attitude of the sampler (no bus access).
          *
          * @author  Alexander Miller
          * @date    13.08.2017
@@ -179,68 +275,199 @@ namespace HexPi
 
         public void read()
         {
-            try
+            if (device == null)
+            {
+                Debug.WriteLine("Error: Accelerometer: No device!");
+                return;
+            }
+            current = latest.read();
+        }
+
+
+
+        /**
+         * @fn  public long takeBusTime()
+         *
+         * @brief   Gets the time the sampler spent on the bus since the last call
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The bus time in stopwatch ticks.
+         */
+
+        public long takeBusTime()
+        {
+            return Interlocked.Exchange(ref busTime, 0);
+        }
+
+
+
+        /**
+         * @fn  private void sample()
+         *
+         * @brief   Drains the FIFO until the application ends (runs on its own thread)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        private void sample()
+        {
+            while (true)
             {
-                if (device != null)
+                //the FIFO reads share I2C1 with the legs
+                long start = Stopwatch.GetTimestamp();
+                try
                 {
-                    //number of measurements 
-                    int length = 10;
-                    //status flag
-                    bool status = false;
-                    //read buffer for register status
-                    byte[] STATUS_REG = new byte[1];
-                    //write buffer with initializing
-                    device.Write(new byte[] { 0x10, 0x80 });
-                    for (int i = 0; i < length; i++)
-                    {
-                        //while no new value
-                        while (!status)
-                        {
-                            //set status address
-                            device.Write(new byte[] { 0x1E });
-                            //read status byte
-                            device.Read(STATUS_REG);
-                            status = (STATUS_REG[0] & 1) == 1;
-                        }
-                        status = false;
-                        //write address of first value
-                        device.Write(writeBuffer);
-                        //read 6 bytes
-                        device.Read(readBuffer);
-                        //combine 2 bytes into a 16bit number and add it
-                        x += Math.Round(((Int16)(readBuffer[1] << 8 | readBuffer[0]) / 16383.0), 2);
-                        y += Math.Round(((Int16)(readBuffer[3] << 8 | readBuffer[2]) / 16383.0), 2);
-                        z += Math.Round(((Int16)(readBuffer[5] << 8 | readBuffer[4]) / 16383.0), 2);
-
-                    }
-
-                    //save new value and remove old value
-                    xVal[2] = xVal[1];
-                    xVal[1] = xVal[0];
-                    xVal[0] = Math.Round(x / length, 2);
-                    //weighted average ()25%,50%,25%)
-                    x = 0.25 * xVal[0] + 0.5 * xVal[1] + 0.25 * xVal[2];
-
-                    yVal[2] = yVal[1];
-                    yVal[1] = yVal[0];
-                    yVal[0] = Math.Round(y / length, 2);
-                    y = 0.25 * yVal[0] + 0.5 * yVal[1] + 0.25 * yVal[2];
-
-                    zVal[2] = zVal[1];
-                    zVal[1] = zVal[0];
-                    zVal[0] = Math.Round(z / length, 2);
-                    z = 0.25 * zVal[0] + 0.5 * zVal[1] + 0.25 * zVal[2];
+                    drain();
                 }
-                else
+                catch
                 {
-                    Debug.WriteLine("Error: Accelerometer: No device!");
+                    Debug.WriteLine("Error: Accelerometer: Read failed!");
                 }
+                Interlocked.Add(ref busTime, Stopwatch.GetTimestamp() - start);
+                pause.WaitOne(interval);
+            }
+        }
 
+
+
+        /**
+         * @fn  private void drain()
+         *
+         * @brief   Reads all complete samples of the FIFO with one burst read and publishes the new attitude.
+         *          1. Read the number of unread words and the word that comes next
+         *          2. Skip the rest of an incomplete sample (only after an overrun)
+         *          3. Read the samples (the address rolls back to the FIFO output after each word)
+         *          4. Combine the 2 bytes of each axis to a 16bit value and fuse each sample
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        private void drain()
+        {
+            device.WriteRead(statusAddress, statusBuffer);
+            int words = (statusBuffer[1] & 0x0F) << 8 | statusBuffer[0];
+            int pattern = (statusBuffer[3] & 0x03) << 8 | statusBuffer[2];
+
+            if (pattern != 0 && words >= sampleWords - pattern)
+            {
+                device.WriteRead(dataAddress, buffer(sampleWords - pattern));
+                words -= sampleWords - pattern;
             }
-            catch
+
+            //only complete samples, the rest stays in the FIFO and keeps the order
+            int samples = Math.Min(words / sampleWords, maxSamples);
+            if (samples == 0)
+            {
+                return;
+            }
+
+            byte[] data = buffer(samples * sampleWords);
+            device.WriteRead(dataAddress, data);
+            long timestamp = Stopwatch.GetTimestamp();
+
+            for (int i = 0; i < data.Length; i += 2 * sampleWords)
+            {
+                fuse((Int16)(data[i + 1] << 8 | data[i]) * gyroScale,
+                    (Int16)(data[i + 3] << 8 | data[i + 2]) * gyroScale,
+                    (Int16)(data[i + 7] << 8 | data[i + 6]) * accelScale,
+                    (Int16)(data[i + 9] << 8 | data[i + 8]) * accelScale,
+                    (Int16)(data[i + 11] << 8 | data[i + 10]) * accelScale);
+            }
+
+            ImuSample s = new ImuSample();
+            s.Timestamp = timestamp;
+            s.Pitch = pitch * angleScale;
+            s.Roll = roll * angleScale;
+            s.PitchRate = pitchRate * angleScale;
+            s.RollRate = rollRate * angleScale;
+            latest.publish(s);
+        }
+
+
+
+        /**
+         * @fn  private void fuse(double gx, double gy, double x, double y, double z)
+         *
+         * @brief   Complementary filter for one sample.
+         *          The pitch turns around y, the roll around -x (same directions as the angles of the accelerometer).
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   gx  The rate around x in rad/s.
+         * @param   gy  The rate around y in rad/s.
+         * @param   x   The x value in g.
+         * @param   y   The y value in g.
+         * @param   z   The z value in g.
+         */
+
+        private void fuse(double gx, double gy, double x, double y, double z)
+        {
+            double accelPitch = tilt(x, z);
+            double accelRoll = tilt(y, z);
+            pitchRate = gy;
+            rollRate = -gx;
+
+            if (!started)
+            {
+                pitch = accelPitch;
+                roll = accelRoll;
+                started = true;
+                return;
+            }
+
+            pitch = alpha * (pitch + pitchRate / rate) + (1 - alpha) * accelPitch;
+            roll = alpha * (roll + rollRate / rate) + (1 - alpha) * accelRoll;
+        }
+
+
+
+        /**
+         * @fn  private static double tilt(double a, double z)
+         *
+         * @brief   Calculates the tilt around one axis from the direction of gravity
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   a   The value of the x or y axis.
+         * @param   z   The value of the z axis.
+         *
+         * @return  The angle in rad (0 without gravity).
+         */
+
+        private static double tilt(double a, double z)
+        {
+            //same as acos(a / sqrt(a * a + z * z)) - pi / 2
+            return -Math.Atan2(a, Math.Abs(z));
+        }
+
+
+
+        /**
+         * @fn  private byte[] buffer(int words)
+         *
+         * @brief   Gets the read buffer for a number of words (created once)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   words   The number of words.
+         *
+         * @return  The buffer.
+         */
+
+        private byte[] buffer(int words)
+        {
+            if (dataBuffers[words] == null)
             {
-                Debug.WriteLine("Error: Accelerometer: Read failed!");
+                dataBuffers[words] = new byte[words * 2];
             }
+            return dataBuffers[words];
         }
         #endregion Functions
 
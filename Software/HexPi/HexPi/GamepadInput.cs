@@ -0,0 +1,275 @@
+﻿/**********************************************************************************************//**
+ * @file    GamepadInput.cs
+ *
+ * @brief   Implements the gamepad input class.
+ **************************************************************************************************/
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using Windows.Gaming.Input;
+
+namespace HexPi
+{
+
+    /**
+     * @class   GamepadInput
+     *
+     * @brief   The XBox360 Wireless Gamepad as input device.
+     *          A background thread reads the gamepad, shapes the axes (dead zones) and publishes the reading
+     *          with its timestamp. read() only takes the latest reading, so the control tick never waits for
+     *          the gamepad and never sees a half written reading.
+     *          The timestamp is the time the gamepad took the reading (converted to the stopwatch), so it does
+     *          not change while the reading does not and includes the time until the next poll.
+     *
+     * @author  Alexander Miller
+     * @date    13.08.2017
+     */
+
+    class GamepadInput : IInputSource
+    {
+        #region Objects
+        /** @brief   The input device (XBox360 Wireless Gamepad, set by the handlers, read by the sampler). */
+        Gamepad input = null;
+
+        /** @brief   The latest reading (written by the sampler, timestamp 0 = no gamepad). */
+        SampleSlot<InputState> latest = new SampleSlot<InputState>();
+
+        /** @brief   The sampler thread. */
+        Task sampler = null;
+
+        /** @brief   Never set, waits between the readings. */
+        ManualResetEvent pause = new ManualResetEvent(false);
+
+        /** @brief   The gamepad the clock offset belongs to (sampler). */
+        Gamepad clocked = null;
+        #endregion Objects
+
+        #region Fields
+        /** @brief   The smallest difference between the stopwatch and the gamepad clock in microseconds (sampler). */
+        private long clockOffset = long.MaxValue;
+        #endregion Fields
+
+        #region CONSTANTS
+        /** @brief   The time between two readings in milliseconds. */
+        private const int interval = 5;
+
+        /** @brief   The radius of the dead zone of the thumbsticks. */
+        private const double stickDeadZone = 0.1;
+
+        /** @brief   The dead zone of the triggers. */
+        private const double triggerDeadZone = 0.05;
+        #endregion CONSTANTS
+
+        #region Functions
+
+        /**
+         * @fn  public GamepadInput()
+         *
+         * @brief   Initializes the gamepad for use as input device and starts the sampler.
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         */
+
+        public GamepadInput()
+        {
+
+
+            if (Gamepad.Gamepads.Count() > 0)
+            {
+                input = Gamepad.Gamepads.First();
+                Debug.WriteLine("Info: Gamepad connected!");
+            }
+            else
+            {
+                Debug.WriteLine("Warning: No Gamepad connected!");
+            }
+
+            Gamepad.GamepadAdded += gamepadAddedHandler;
+            Gamepad.GamepadRemoved += gamepadRemovedHandler;
+
+            sampler = Task.Factory.StartNew(sample, TaskCreationOptions.LongRunning);
+        }
+
+
+
+        /**
+         * @fn  public bool read(out InputState state)
+         *
+         * @brief   Gets the latest gamepad reading of the sampler
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param [out] state   The reading.
+         *
+         * @return  False if no gamepad was found.
+         */
+
+        public bool read(out InputState state)
+        {
+            state = latest.read();
+            return state.Timestamp != 0;
+        }
+
+
+
+        /**
+         * @fn  private void sample()
+         *
+         * @brief   Reads the gamepad until the application ends (long running task, its own thread)
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        private void sample()
+        {
+            while (true)
+            {
+                try
+                {
+                    latest.publish(take());
+                }
+                catch
+                {
+                    Debug.WriteLine("Error: Gamepad: Read failed!");
+                }
+                pause.WaitOne(interval);
+            }
+        }
+
+
+
+        /**
+         * @fn  private InputState take()
+         *
+         * @brief   Reads the gamepad once and shapes the axes
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The reading (empty if no gamepad was found).
+         */
+
+        private InputState take()
+        {
+            InputState state = new InputState();
+            Gamepad pad = Volatile.Read(ref input);
+
+            //if no gamepad was found
+            if (pad == null)
+            {
+                //search for gamepad
+                if (Gamepad.Gamepads.Count() > 0)
+                {
+                    Interlocked.CompareExchange(ref input, Gamepad.Gamepads.First(), null);
+                }
+                return state;
+            }
+
+            //Get current Gamepadreading
+            GamepadReading gamepadStatus = pad.GetCurrentReading();
+            state.Timestamp = getTimestamp(pad, gamepadStatus.Timestamp);
+            state.LeftThumbstickX = gamepadStatus.LeftThumbstickX;
+            state.LeftThumbstickY = gamepadStatus.LeftThumbstickY;
+            state.RightThumbstickX = gamepadStatus.RightThumbstickX;
+            state.RightThumbstickY = gamepadStatus.RightThumbstickY;
+            DeadZone.apply(ref state.LeftThumbstickX, ref state.LeftThumbstickY, stickDeadZone);
+            DeadZone.apply(ref state.RightThumbstickX, ref state.RightThumbstickY, stickDeadZone);
+            state.LeftTrigger = DeadZone.apply(gamepadStatus.LeftTrigger, triggerDeadZone);
+            state.RightTrigger = DeadZone.apply(gamepadStatus.RightTrigger, triggerDeadZone);
+            state.Buttons = (Controller.buttons)gamepadStatus.Buttons;
+            return state;
+        }
+
+
+
+        /**
+         * @fn  private long getTimestamp(Gamepad pad, ulong timestamp)
+         *
+         * @brief   Converts the timestamp of a reading (microseconds on the clock of the gamepad) to the stopwatch.
+         *          The smallest difference between both clocks seen so far is their offset (plus the shortest
+         *          delivery time), the age of a reading is how much the current difference exceeds it.
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   pad         The gamepad.
+         * @param   timestamp   The timestamp of the reading.
+         *
+         * @return  The timestamp in stopwatch ticks.
+         */
+
+        private long getTimestamp(Gamepad pad, ulong timestamp)
+        {
+            //another gamepad may have another clock
+            if (pad != clocked)
+            {
+                clocked = pad;
+                clockOffset = long.MaxValue;
+            }
+
+            long now = Stopwatch.GetTimestamp();
+            long offset = (long)(now * (1000000.0 / Stopwatch.Frequency)) - (long)timestamp;
+            if (offset < clockOffset)
+            {
+                clockOffset = offset;
+            }
+            return now - (offset - clockOffset) * Stopwatch.Frequency / 1000000;
+        }
+
+
+
+        /**
+         * @fn  private void gamepadRemovedHandler(object sender, Gamepad e)
+         *
+         * @brief   Handler, called when the gamepad is removed
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         *
+         * @param   sender  Source of the event.
+         * @param   e       A Gamepad to process.
+         */
+
+        private void gamepadRemovedHandler(object sender, Gamepad e)
+        {
+            Volatile.Write(ref input, null);
+            Debug.WriteLine("Warning: Gamepad was removed.");
+        }
+
+
+
+        /**
+         * @fn  private void gamepadAddedHandler(object sender, Gamepad e)
+         *
+         * @brief   Handler, called when the gamepad is added.
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         *
+         * @param   sender  Source of the event.
+         * @param   e       A Gamepad to process.
+         */
+
+        private void gamepadAddedHandler(object sender, Gamepad e)
+        {
+            if (Gamepad.Gamepads.Count() > 0)
+            {
+                Volatile.Write(ref input, Gamepad.Gamepads.First());
+            }
+            else
+            {
+                Debug.WriteLine("Error: Could not add Gamepad!");
+            }
+        }
+
+        #endregion Functions
+    }
+}
@@ -0,0 +1,136 @@
+﻿/**********************************************************************************************//**
+ * @file    I2cLegBus.cs
+ *
+ * @brief   Implements the i2c leg bus class.
+ **************************************************************************************************/
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using Windows.Devices.Enumeration;
+using Windows.Devices.I2c;
+
+namespace HexPi
+{
+
+    /**
+     * @class   I2cLegBus
+     *
+     * @brief   The i2c connection to a legcontroller.
+     *          A legcontroller that does not acknowledge (NACK) fails the transfer, other errors of the driver
+     *          are thrown to the caller (BusMetrics counts and logs them).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class I2cLegBus : ILegBus
+    {
+        #region Objects
+        /** @brief   The i2c-device. */
+        I2cDevice device = null;
+
+        #endregion Objects
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public I2cLegBus(byte address)
+         *
+         * @brief   Constructor
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   address The i2c address.
+         */
+
+        public I2cLegBus(byte address)
+        {
+            init(address);
+        }
+
+
+
+        /**
+         * @fn  public async void init(byte address)
+         *
+         * @brief   Initializes this device
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         *
+         * @param   address The i2c address.
+         */
+
+        public async void init(byte address)
+        {
+            try
+            {
+                I2cConnectionSettings settings = new I2cConnectionSettings(address); // Address
+                settings.BusSpeed = I2cBusSpeed.FastMode;
+                settings.SharingMode = I2cSharingMode.Shared;
+                string aqs = I2cDevice.GetDeviceSelector("I2C1");
+                DeviceInformationCollection dis = await DeviceInformation.FindAllAsync(aqs);
+                device = await I2cDevice.FromIdAsync(dis[0].Id, settings);
+            }
+            catch
+            {
+                Debug.WriteLine("Error: I2C init failed!");
+            }
+        }
+
+
+
+        /**
+         * @fn  public bool write(byte[] data)
+         *
+         * @brief   Sends a data array over i2c
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         *
+         * @param   data    The data.
+         *
+         * @return  False if the legcontroller did not acknowledge all bytes (or is not initialized).
+         */
+
+        public bool write(byte[] data)
+        {
+            if (device == null)
+            {
+                return false;
+            }
+            return device.WritePartial(data).Status == I2cTransferStatus.FullTransfer;
+        }
+
+
+
+        /**
+         * @fn  public bool read(byte[] data)
+         *
+         * @brief   Reads a data array over i2c
+         *
+         * @author  Alexander Miller
+         * @date    13.08.2017
+         *
+         * @param   data    The buffer.
+         *
+         * @return  True if the buffer was filled (false on a NACK).
+         */
+
+        public bool read(byte[] data)
+        {
+            if (device == null)
+            {
+                return false;
+            }
+            return device.ReadPartial(data).Status == I2cTransferStatus.FullTransfer;
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,74 @@
+﻿/**********************************************************************************************//**
+ * @file    LegControllerBackend.cs
+ *
+ * @brief   Implements the legcontroller backend class.
+ **************************************************************************************************/
+
+namespace HexPi
+{
+
+    /**
+     * @class   LegControllerBackend
+     *
+     * @brief   One legcontroller per leg. Every leg is written directly, the inverse kinematics run on the legcontrollers.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class LegControllerBackend : IActuatorBackend
+    {
+
+        /**
+         * @property    public bool Calibrated
+         *
+         * @brief   The legcontrollers keep their calibration in the eeprom
+         *
+         * @return  True.
+         */
+
+        public bool Calibrated => true;
+
+        /**
+         * @property    public long FramePeriod
+         *
+         * @brief   The legcontrollers update their servos every 20ms (TCD0.PER, the compare values are buffered)
+         *
+         * @return  20000us.
+         */
+
+        public long FramePeriod => 20000;
+
+        /**
+         * @fn  public ILegBus open(byte address, int index)
+         *
+         * @brief   Opens the i2c connection to a legcontroller
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   address The i2c address.
+         * @param   index   The position of the leg (0 - 5).
+         *
+         * @return  The bus of the leg.
+         */
+
+        public ILegBus open(byte address, int index)
+        {
+            return new I2cLegBus(address);
+        }
+
+        /**
+         * @fn  public void flush()
+         *
+         * @brief   Nothing to do, the legcontrollers receive their data directly.
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void flush()
+        {
+        }
+    }
+}
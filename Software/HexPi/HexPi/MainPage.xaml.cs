@@ -28,8 +28,9 @@ namespace HexPi
         public MainPage()
         {
             this.InitializeComponent();
-            control = new Controller();
+            control = Startup.createController();
             control.init();
+            control.start();
 
             //timer = new DispatcherTimer();
             //timer.Interval = System.TimeSpan.FromMilliseconds(10);
@@ -0,0 +1,249 @@
+﻿/**********************************************************************************************//**
+ * @file    ServoHat.cs
+ *
+ * @brief   Implements the servo hat class.
+ **************************************************************************************************/
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using Windows.Devices.Enumeration;
+using Windows.Devices.I2c;
+
+namespace HexPi
+{
+
+    /**
+     * @class   ServoHat
+     *
+     * @brief   The Raspberry Pi servo hat. Drives all servos of the robot with one i2c write per frame.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class ServoHat
+    {
+        #region Objects
+        /** @brief   The i2c-device. */
+        I2cDevice device = null;
+
+        #endregion Objects
+
+        #region Fields
+
+        /** @brief   The number of servo channels. */
+        private int channels = 0;
+
+        #endregion Fields
+
+        #region CONSTANTS
+
+        /** @brief   The i2c address of the servo hat. */
+        private const byte address = 0x42;
+
+        /** @brief   The marker in front of the servo values. */
+        private const byte frameStart = 11;
+
+        /** @brief   The marker behind the servo values. */
+        private const byte frameEnd = 22;
+
+        /** @brief   The command to set the number of channels and the frame period. */
+        private const byte cmdConfig = 44;
+
+        /** @brief   The servo value for 1.5ms (0°). */
+        private const double stdVal = 187.5;
+
+        /** @brief   The minimum servo value (1ms). */
+        private const byte minVal = 125;
+
+        /** @brief   The maximum servo value (2ms). */
+        private const byte maxVal = 250;
+
+        /** @brief   The servo value per degree (1ms = 90° = 125 values). */
+        private const double valPerDeg = 125.0 / 90.0;
+
+        /** @brief   The time of a slot (two channels) in microseconds (SLOT_TIME_US of the hat). */
+        private const long slotTime = 2048;
+
+        #endregion CONSTANTS
+
+        #region PROPERTIES
+
+        /**
+         * @property    public long FramePeriod
+         *
+         * @brief   Gets the frame period of the hat (shortest possible, one slot per two channels)
+         *
+         * @return  The period in microseconds.
+         */
+
+        public long FramePeriod
+        {
+            get { return (channels + 1) / 2 * slotTime; }
+        }
+
+        #endregion PROPERTIES
+
+        #region Arrays
+
+        /** @brief   The frame (start marker, one value per channel, end marker). */
+        private byte[] frame;
+
+        #endregion Arrays
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public ServoHat(int channels)
+         *
+         * @brief   Constructor
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   channels    The number of servo channels.
+         */
+
+        public ServoHat(int channels)
+        {
+            this.channels = channels;
+
+            frame = new byte[channels + 2];
+            frame[0] = frameStart;
+            for (int i = 1; i <= channels; i++)
+            {
+                frame[i] = (byte)stdVal;
+            }
+            frame[channels + 1] = frameEnd;
+
+            init();
+        }
+
+
+
+        /**
+         * @fn  public async void init()
+         *
+         * @brief   Initializes the i2c device and sets the number of active channels (shortest frame period).
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public async void init()
+        {
+            try
+            {
+                I2cConnectionSettings settings = new I2cConnectionSettings(address); // Address
+                settings.BusSpeed = I2cBusSpeed.FastMode;
+                settings.SharingMode = I2cSharingMode.Shared;
+                string aqs = I2cDevice.GetDeviceSelector("I2C1");
+                DeviceInformationCollection dis = await DeviceInformation.FindAllAsync(aqs);
+                device = await I2cDevice.FromIdAsync(dis[0].Id, settings);
+
+                device.Write(new byte[] { cmdConfig, (byte)channels, 0 });
+            }
+            catch
+            {
+                Debug.WriteLine("Error: Servo hat init failed!");
+            }
+        }
+
+
+
+        /**
+         * @fn  public void setServo(int channel, int degree)
+         *
+         * @brief   Sets the position of a servo for the next frame.
+         *          The hat resolves 8us per value, so the position is limited to -45° - 45° (1ms - 2ms).
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   channel The channel (0 - channels-1).
+         * @param   degree  The angle in degrees.
+         */
+
+        public void setServo(int channel, int degree)
+        {
+            double value = Math.Round(stdVal + degree * valPerDeg);
+
+            //check boundaries
+            if (value < minVal)
+            {
+                value = minVal;
+            }
+            else if (value > maxVal)
+            {
+                value = maxVal;
+            }
+
+            frame[channel + 1] = (byte)value;
+        }
+
+
+
+        /**
+         * @fn  public void flush()
+         *
+         * @brief   Sends the positions of all servos in one i2c write.
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void flush()
+        {
+            try
+            {
+                if (device != null)
+                {
+                    device.Write(frame);
+                }
+            }
+            catch (Exception e)
+            {
+                Debug.WriteLine("Error: I2C servo hat write failed!" + e.Message);
+            }
+        }
+
+
+
+        /**
+         * @fn  public byte[] readStatistics()
+         *
+         * @brief   Reads the jitter statistics of the servo hat (only recorded by the debug firmware).
+         *          Layout: channels, slots, min/max latency of OVF, COMPA and COMPB (uint16),
+         *          min/max pulse width error per channel (int16), all little endian in cpu cycles (125ns).
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The statistics or null if the read failed.
+         */
+
+        public byte[] readStatistics()
+        {
+            try
+            {
+                if (device != null)
+                {
+                    byte[] stats = new byte[2 + 12 + 4 * 24];
+                    device.Read(stats);
+                    return stats;
+                }
+            }
+            catch (Exception e)
+            {
+                Debug.WriteLine("Error: I2C servo hat read failed!" + e.Message);
+            }
+            return null;
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,88 @@
+﻿/**********************************************************************************************//**
+ * @file    ServoHatBackend.cs
+ *
+ * @brief   Implements the servo hat backend class.
+ **************************************************************************************************/
+
+namespace HexPi
+{
+
+    /**
+     * @class   ServoHatBackend
+     *
+     * @brief   All servos on the servo hat. The inverse kinematics run on the pi, the positions of all legs
+     *          are sent in one i2c write per tick. Leg n uses the channels 3n (gamma), 3n+1 (beta) and 3n+2 (alpha).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class ServoHatBackend : IActuatorBackend
+    {
+        #region Objects
+        /** @brief   The servo hat. */
+        ServoHat hat = new ServoHat(18);
+        #endregion Objects
+
+        #region PROPERTIES
+
+        /**
+         * @property    public bool Calibrated
+         *
+         * @brief   The legs on the servo hat need the calibration at startup
+         *
+         * @return  False.
+         */
+
+        public bool Calibrated => false;
+
+        /**
+         * @property    public long FramePeriod
+         *
+         * @brief   Gets the frame period of the servo hat
+         *
+         * @return  The period in microseconds.
+         */
+
+        public long FramePeriod => hat.FramePeriod;
+
+        #endregion PROPERTIES
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public ILegBus open(byte address, int index)
+         *
+         * @brief   Opens the channels of a leg
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   address The i2c address of the legcontroller (side of the leg).
+         * @param   index   The position of the leg (0 - 5).
+         *
+         * @return  The bus of the leg.
+         */
+
+        public ILegBus open(byte address, int index)
+        {
+            return new ServoHatLegBus(address, hat, 3 * index);
+        }
+
+        /**
+         * @fn  public void flush()
+         *
+         * @brief   Sends the positions of all servos to the servo hat
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void flush()
+        {
+            hat.flush();
+        }
+
+        #endregion FUNCTIONS
+    }
+}
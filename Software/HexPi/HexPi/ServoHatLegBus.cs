@@ -0,0 +1,79 @@
+﻿/**********************************************************************************************//**
+ * @file    ServoHatLegBus.cs
+ *
+ * @brief   Implements the servo hat leg bus class.
+ **************************************************************************************************/
+
+namespace HexPi
+{
+
+    /**
+     * @class   ServoHatLegBus
+     *
+     * @brief   A leg driven by three channels of the servo hat. The legcontroller firmware runs on the pi.
+     *          The servo hat can not sense the ground, so terrain mode sets positions without sensing.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class ServoHatLegBus : LegEmulator
+    {
+        #region Objects
+        /** @brief   The servo hat. */
+        ServoHat hat = null;
+        #endregion Objects
+
+        #region FIELDS
+
+        /** @brief   The first servo hat channel of this leg. */
+        private int channel = 0;
+
+        #endregion FIELDS
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public ServoHatLegBus(byte address, ServoHat hat, int channel)
+         *
+         * @brief   Constructor
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   address The i2c address of the legcontroller (side of the leg).
+         * @param   hat     The servo hat.
+         * @param   channel The first of the three servo hat channels.
+         */
+
+        public ServoHatLegBus(byte address, ServoHat hat, int channel) : base(address, false)
+        {
+            this.hat = hat;
+            this.channel = channel;
+        }
+
+
+
+        /**
+         * @fn  protected override void setServos(int s0, int s1, int s2)
+         *
+         * @brief   Sets the servo angles for the next servo hat frame
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   s0  Angle of servo 0 (gamma) in degrees.
+         * @param   s1  Angle of servo 1 (beta) in degrees.
+         * @param   s2  Angle of servo 2 (alpha) in degrees.
+         */
+
+        protected override void setServos(int s0, int s1, int s2)
+        {
+            hat.setServo(channel, s0);
+            hat.setServo(channel + 1, s1);
+            hat.setServo(channel + 2, s2);
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,129 @@
+﻿/**********************************************************************************************//**
+ * @file    SocketMetricsListener.cs
+ *
+ * @brief   Implements the socket metrics listener class.
+ **************************************************************************************************/
+
+using System;
+using System.IO;
+using System.Threading;
+using Windows.Networking;
+using Windows.Networking.Sockets;
+
+namespace HexPi
+{
+
+    /**
+     * @class   SocketMetricsListener
+     *
+     * @brief   Accepts the connections of the metrics endpoint with a StreamSocketListener (the UWP framework
+     *          has no TcpListener). The connections arrive on the thread pool, a lock answers one at a time.
+     *          Needs the privateNetworkClientServer capability.
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    class SocketMetricsListener : IMetricsListener
+    {
+        #region Objects
+        /** @brief   The listener. */
+        StreamSocketListener listener = null;
+
+        /** @brief   Answers a connection. */
+        Action<Stream, Stream> connected = null;
+
+        /** @brief   Lock for the connection being answered. */
+        object answerLock = new object();
+        #endregion Objects
+
+        #region CONSTANTS
+        /** @brief   The time a client has to send its request and receive the metrics in milliseconds. */
+        private const int timeout = 2000;
+        #endregion CONSTANTS
+
+        #region FUNCTIONS
+
+        /**
+         * @fn  public int start(int port, Action<Stream, Stream> connected)
+         *
+         * @brief   Starts listening on localhost
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   port        The port (0 = any free port).
+         * @param   connected   Answers a connection.
+         *
+         * @return  The port.
+         */
+
+        public int start(int port, Action<Stream, Stream> connected)
+        {
+            this.connected = connected;
+            listener = new StreamSocketListener();
+            listener.ConnectionReceived += received;
+            listener.BindEndpointAsync(new HostName("localhost"), port == 0 ? "" : port.ToString()).AsTask().Wait();
+            return int.Parse(listener.Information.LocalPort);
+        }
+
+
+
+        /**
+         * @fn  public void stop()
+         *
+         * @brief   Stops listening and waits for the connection being answered
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         */
+
+        public void stop()
+        {
+            if (listener == null)
+            {
+                return;
+            }
+            listener.ConnectionReceived -= received;
+            listener.Dispose();
+            lock (answerLock)
+            {
+                listener = null;
+            }
+        }
+
+
+
+        /**
+         * @fn  private void received(StreamSocketListener sender, StreamSocketListenerConnectionReceivedEventArgs args)
+         *
+         * @brief   Answers a connection, closes it if the client takes longer than the timeout
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @param   sender  The listener.
+         * @param   args    The connection.
+         */
+
+        private void received(StreamSocketListener sender, StreamSocketListenerConnectionReceivedEventArgs args)
+        {
+            using (StreamSocket socket = args.Socket)
+            {
+                lock (answerLock)
+                {
+                    if (listener == null)
+                    {
+                        return;
+                    }
+                    using (new Timer(s => socket.Dispose(), null, timeout, Timeout.Infinite))
+                    {
+                        connected(socket.InputStream.AsStreamForRead(0), socket.OutputStream.AsStreamForWrite(0));
+                    }
+                }
+            }
+        }
+
+        #endregion FUNCTIONS
+    }
+}
@@ -0,0 +1,106 @@
+﻿/**********************************************************************************************//**
+ * @file    Startup.cs
+ *
+ * @brief   Implements the startup class.
+ **************************************************************************************************/
+
+using System;
+using System.IO;
+using Windows.Storage;
+using Windows.System;
+
+namespace HexPi
+{
+
+    /**
+     * @class   Startup
+     *
+     * @brief   Creates the controller with the devices of the Raspberry Pi (gamepad, accelerometer, actuators).
+     *
+     * @author  Alexander Miller
+     * @date    19.10.2026
+     */
+
+    static class Startup
+    {
+        #region Fields
+
+        /** @brief   The actuator backend selected at startup. */
+        static byte backend = (byte)backends.LEGCONTROLLER;
+
+        #endregion Fields
+
+        #region Enums
+
+        /**
+         * @enum    backends
+         *
+         * @brief   Values that represent the output backends
+         *          LEGCONTROLLER = one legcontroller per leg (inverse kinematics on the legcontroller)
+         *          SERVOHAT = all servos on the servo hat (inverse kinematics on the pi, one i2c write per tick)
+         *          SIMULATION = simulated legcontrollers (no hardware)
+         *          RECORDER = simulated legcontrollers, every frame is recorded in memory
+         */
+
+        public enum backends { LEGCONTROLLER, SERVOHAT, SIMULATION, RECORDER };
+
+        #endregion Enums
+
+        #region Functions
+
+        /**
+         * @fn  public static Controller createController()
+         *
+         * @brief   Creates the controller
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The controller.
+         */
+
+        public static Controller createController()
+        {
+            Controller control = new Controller(new GamepadInput(), new Accelerometer(), createBackend());
+            control.ShutdownRequested = () => ShutdownManager.BeginShutdown(ShutdownKind.Shutdown, new TimeSpan(0));
+            //send the frames on the bus thread, the next tick is calculated meanwhile
+            control.Pipelined = true;
+            //transfers of each leg and latency as Prometheus text on http://localhost:9110/metrics
+            control.MetricsPort = 9110;
+            control.MetricsListener = new SocketMetricsListener();
+            //the last ticks in the local folder of the app (HexPi.Host --decode exports them as CSV)
+            control.RecorderPath = Path.Combine(ApplicationData.Current.LocalFolder.Path, "flight.hxr");
+            return control;
+        }
+
+
+
+        /**
+         * @fn  private static IActuatorBackend createBackend()
+         *
+         * @brief   Creates the selected actuator backend
+         *
+         * @author  Alexander Miller
+         * @date    19.10.2026
+         *
+         * @return  The actuator backend.
+         */
+
+        private static IActuatorBackend createBackend()
+        {
+            switch (backend)
+            {
+                case (byte)backends.SERVOHAT:
+                    return new ServoHatBackend();
+                case (byte)backends.SIMULATION:
+                    return new SimulatedBackend();
+                case (byte)backends.RECORDER:
+                    return new RecordingBackend(new SimulatedBackend());
+                default:
+                    return new LegControllerBackend();
+            }
+        }
+
+        #endregion Functions
+    }
+}
@@ -8,6 +8,7 @@
 
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <avr/eeprom.h>
 #include <util/twi.h>
 
 /**********************************************************************************************//**
@@ -30,7 +31,7 @@
  * @date	11.08.2016
  **************************************************************************************************/
 
-#define NUM_SERVOS 24 // 20 is the recommended maximum value (Servos get slower because of longer standby time (>20ms))
+#define NUM_SERVOS 24 // maximum number of outputs, the number of active channels is set at runtime (CMD_CONFIG)
 
 /**********************************************************************************************//**
  * @def	SERVO_STD_VAL
@@ -131,14 +132,243 @@
 
 #define LED3_OFF PORTD&=~(1<<PD2) //MACRO: Turn LED3 off
 
+/**********************************************************************************************//**
+ * @def	CMD_STATS_RESET
+ *
+ * @brief	A macro that defines the command to reset the jitter statistics.
+ * 			Commands use values below SERVO_MIN_VAL, so they can not be mistaken for servo data.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+#define CMD_STATS_RESET 33
+
+/**********************************************************************************************//**
+ * @def	CMD_CONFIG
+ *
+ * @brief	A macro that defines the command to set the number of active channels and the frame period.
+ * 			Followed by 2 bytes: number of channels (1 - NUM_SERVOS), frame period in ms (0 = shortest possible).
+ * 			The configuration is saved in the eeprom.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+#define CMD_CONFIG 44
+
+/**********************************************************************************************//**
+ * @def	CMD_LAYOUT
+ *
+ * @brief	A macro that defines the command to set the slot layout.
+ * 			Followed by one byte per active channel: the output (0 = SERVO_1 - 23 = SERVO_24) driven by this channel.
+ * 			The layout is saved in the eeprom.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+#define CMD_LAYOUT 55
+
+/**********************************************************************************************//**
+ * @def	SLOT_TIME_US
+ *
+ * @brief	A macro that defines the length of one slot (time per timer overflow) in microseconds.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+#define SLOT_TIME_US 2048UL
+
+/**********************************************************************************************//**
+ * @def	FRAME_MAX_MS
+ *
+ * @brief	A macro that defines the maximum frame period in ms.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+#define FRAME_MAX_MS 50
+
+/**********************************************************************************************//**
+ * @def	MAX_SLOTS
+ *
+ * @brief	A macro that defines the maximum number of slots per frame.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+#define MAX_SLOTS ((FRAME_MAX_MS * 1000UL + SLOT_TIME_US - 1) / SLOT_TIME_US)
+
+/**********************************************************************************************//**
+ * @def	IDLE_CHANNEL
+ *
+ * @brief	A macro that defines the channel index of unused slot positions.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+#define IDLE_CHANNEL NUM_SERVOS
+
+/**********************************************************************************************//**
+ * @def	EEPROM_MAGIC
+ *
+ * @brief	A macro that defines the value marking a valid configuration in the eeprom.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+#define EEPROM_MAGIC 0xA5
+
+/**********************************************************************************************//**
+ * @def	EEPROM_ADDR_MAGIC
+ *
+ * @brief	A macro that defines the eeprom address of the magic byte,
+ * 			followed by the number of channels, the frame period and the layout.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+#define EEPROM_ADDR_MAGIC 0
+
+/** @brief	Eeprom address of the number of channels. */
+#define EEPROM_ADDR_CHANNELS 1
+
+/** @brief	Eeprom address of the frame period. */
+#define EEPROM_ADDR_FRAME 2
+
+/** @brief	Eeprom address of the layout (NUM_SERVOS bytes). */
+#define EEPROM_ADDR_LAYOUT 3
+
+/** @brief	Number of bytes written by save_config() (invalid magic byte, channels, frame period, layout, magic byte). */
+#define SAVE_STEPS (NUM_SERVOS + 4)
+
+/**********************************************************************************************//**
+ * @def	TX_BUFFER_SIZE
+ *
+ * @brief	A macro that defines the size of the buffer read by the TWI master.
+ * 			Number of channels (1 byte), number of slots (1 byte), min/max entry latency of the three ISRs (12 bytes)
+ * 			and min/max pulse width error of each channel (4 bytes per channel).
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+#define TX_BUFFER_SIZE (2 + 12 + 4 * NUM_SERVOS)
+
+/**********************************************************************************************//**
+ * @struct	servo_pin_t
+ *
+ * @brief	Output port and bit mask of one servo channel.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+typedef struct {
+	volatile uint8_t *port;
+	uint8_t mask;
+} servo_pin_t;
+
+/**********************************************************************************************//**
+ * @struct	servo_slot_t
+ *
+ * @brief	One timer overflow slot. The pulses of channel a and b are started together by the overflow ISR,
+ * 			channel a is ended by COMPA and channel b by COMPB.
+ * 			Port pointers and masks are precomputed, so every slot takes the same number of cycles.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+typedef struct {
+	volatile uint8_t *port_a;
+	uint8_t set_a;
+	uint8_t clear_a;
+	uint8_t channel_a;
+	volatile uint8_t *port_b;
+	uint8_t set_b;
+	uint8_t clear_b;
+	uint8_t channel_b;
+} servo_slot_t;
+
+/** @brief	Output pins of SERVO_1 - SERVO_24 (channel 0 - 23). */
+const servo_pin_t servo_pins[NUM_SERVOS] = {
+	{&PORTD, (1<<PD3)}, {&PORTD, (1<<PD4)}, {&PORTD, (1<<PD5)}, {&PORTD, (1<<PD6)}, //SERVO 1 - 4
+	{&PORTD, (1<<PD7)}, {&PORTC, (1<<PC2)}, {&PORTC, (1<<PC3)}, {&PORTC, (1<<PC4)}, //SERVO 5 - 8
+	{&PORTC, (1<<PC5)}, {&PORTC, (1<<PC6)}, {&PORTC, (1<<PC7)}, {&PORTA, (1<<PA7)}, //SERVO 9 - 12
+	{&PORTA, (1<<PA6)}, {&PORTA, (1<<PA5)}, {&PORTA, (1<<PA4)}, {&PORTA, (1<<PA3)}, //SERVO 13 - 16
+	{&PORTA, (1<<PA2)}, {&PORTA, (1<<PA1)}, {&PORTA, (1<<PA0)}, {&PORTB, (1<<PB0)}, //SERVO 17 - 20
+	{&PORTB, (1<<PB1)}, {&PORTB, (1<<PB2)}, {&PORTB, (1<<PB3)}, {&PORTB, (1<<PB4)}  //SERVO 21 - 24
+};
+
+/** @brief	CHAR ARRAY WITH SERVO DATA (last entry is used by idle slots). */
+unsigned volatile char data[NUM_SERVOS+1];
+
+/** @brief	The slot table (built by init_slots). */
+servo_slot_t slots[MAX_SLOTS];
+
+/** @brief	Dummy port for idle slots. */
+volatile uint8_t idle_port = 0;
+
+/** @brief	Number of active channels. */
+uint8_t num_channels = NUM_SERVOS;
+
+/** @brief	Frame period in ms (0 = as short as the active channels allow). */
+uint8_t frame_ms = 0;
 
+/** @brief	Number of slots per frame. */
+volatile uint8_t num_slots = NUM_SERVOS/2;
 
-/** @brief	CHAR ARRAY WITH SERVO DATA. */
-unsigned volatile char data[NUM_SERVOS];
+/** @brief	Output driven by each channel. */
+uint8_t layout[NUM_SERVOS];
+
+/** @brief	The slot whose pulses are currently running (used by the compare ISRs). */
+servo_slot_t * volatile current_slot = &slots[0];
 
 /** @brief	loop count. */
 unsigned volatile char loop = 0;
 
+/** @brief	Buffer for data read by the TWI master. */
+uint8_t tx_buffer[TX_BUFFER_SIZE];
+
+#ifdef DEBUG
+
+/** @brief	Minimum entry latency of the ISRs in cpu cycles (0 = OVF, 1 = COMPA, 2 = COMPB). */
+volatile uint16_t isr_latency_min[3];
+
+/** @brief	Maximum entry latency of the ISRs in cpu cycles (0 = OVF, 1 = COMPA, 2 = COMPB). */
+volatile uint16_t isr_latency_max[3];
+
+/** @brief	Minimum pulse width error per channel in cpu cycles. */
+volatile int16_t pulse_error_min[NUM_SERVOS+1];
+
+/** @brief	Maximum pulse width error per channel in cpu cycles. */
+volatile int16_t pulse_error_max[NUM_SERVOS+1];
+
+/** @brief	Timer1 value after the pulses of the current slot were started. */
+volatile uint16_t pulse_start = 0;
+
+/** @brief	OCR0A value of the current slot. */
+volatile uint8_t pulse_val_a = SERVO_STD_VAL;
+
+/** @brief	OCR0B value of the current slot. */
+volatile uint8_t pulse_val_b = SERVO_STD_VAL;
+
+/** @brief	OCR0A value of the next slot (becomes active at the next overflow). */
+volatile uint8_t next_val_a = SERVO_STD_VAL;
+
+/** @brief	OCR0B value of the next slot (becomes active at the next overflow). */
+volatile uint8_t next_val_b = SERVO_STD_VAL;
+
+#endif
+
 /**********************************************************************************************//**
  * @fn	void init_twi(void)
  *
@@ -176,7 +406,328 @@ void init_outputs(void){
 
 }
 
+/**********************************************************************************************//**
+ * @fn	void init_config(void)
+ *
+ * @brief	Reads the saved configuration (number of channels, frame period and layout) from the eeprom.
+ * 			Without a valid configuration all NUM_SERVOS channels are active in the default layout.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+void init_config(void){
+
+	for (uint8_t i=0;i<NUM_SERVOS;i++)
+	{
+		layout[i] = i;
+	}
+
+	if (eeprom_read_byte((uint8_t *) EEPROM_ADDR_MAGIC) == EEPROM_MAGIC)
+	{
+		uint8_t channels = eeprom_read_byte((uint8_t *) EEPROM_ADDR_CHANNELS);
+		uint8_t frame = eeprom_read_byte((uint8_t *) EEPROM_ADDR_FRAME);
+
+		if (channels >= 1 && channels <= NUM_SERVOS && frame <= FRAME_MAX_MS)
+		{
+			num_channels = channels;
+			frame_ms = frame;
+		}
+
+		for (uint8_t i=0;i<NUM_SERVOS;i++)
+		{
+			uint8_t output = eeprom_read_byte((uint8_t *) (EEPROM_ADDR_LAYOUT + i));
+			if (output < NUM_SERVOS)
+			{
+				layout[i] = output;
+			}
+		}
+	}
+
+}
+
+/**********************************************************************************************//**
+ * @fn	void save_config(uint8_t step)
+ *
+ * @brief	Saves one byte of the configuration in the eeprom (step 0 to SAVE_STEPS - 1:
+ * 			invalid magic byte, number of channels, frame period, layout, magic byte).
+ * 			The magic byte is cleared first and set last, so a save cut short (power loss)
+ * 			leaves no mix of the old and the new configuration behind, the defaults are loaded instead.
+ * 			Only call it if eeprom_is_ready(), then it starts the write and returns at once.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ *
+ * @param	step	The byte to save.
+ **************************************************************************************************/
+
+void save_config(uint8_t step){
+
+	if (step == 0)
+	{
+		eeprom_update_byte((uint8_t *) EEPROM_ADDR_MAGIC, 0xFF); //erased -> invalid until the last step
+	}
+	else if (step == 1)
+	{
+		eeprom_update_byte((uint8_t *) EEPROM_ADDR_CHANNELS, num_channels);
+	}
+	else if (step == 2)
+	{
+		eeprom_update_byte((uint8_t *) EEPROM_ADDR_FRAME, frame_ms);
+	}
+	else if (step < SAVE_STEPS - 1)
+	{
+		eeprom_update_byte((uint8_t *) (EEPROM_ADDR_LAYOUT + step - 3), layout[step - 3]);
+	}
+	else
+	{
+		eeprom_update_byte((uint8_t *) EEPROM_ADDR_MAGIC, EEPROM_MAGIC);
+	}
 
+}
+
+/**********************************************************************************************//**
+ * @fn	void set_slot(servo_slot_t *s, uint8_t channel_a, uint8_t channel_b)
+ *
+ * @brief	Sets the two channels of a slot. Channels >= num_channels leave the position idle.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ *
+ * @param	s		 	The slot.
+ * @param	channel_a	The channel ended by COMPA.
+ * @param	channel_b	The channel ended by COMPB.
+ **************************************************************************************************/
+
+void set_slot(servo_slot_t *s, uint8_t channel_a, uint8_t channel_b){
+
+	if (channel_a < num_channels)
+	{
+		s->channel_a = channel_a;
+		s->port_a = servo_pins[layout[channel_a]].port;
+		s->set_a = servo_pins[layout[channel_a]].mask;
+	}
+	else
+	{
+		s->channel_a = IDLE_CHANNEL;
+		s->port_a = &idle_port;
+		s->set_a = 0;
+	}
+	s->clear_a = ~s->set_a;
+
+	if (channel_b < num_channels)
+	{
+		s->channel_b = channel_b;
+		s->port_b = servo_pins[layout[channel_b]].port;
+		s->set_b = servo_pins[layout[channel_b]].mask;
+	}
+	else
+	{
+		s->channel_b = IDLE_CHANNEL;
+		s->port_b = &idle_port;
+		s->set_b = 0;
+	}
+	s->clear_b = ~s->set_b;
+
+}
+
+/**********************************************************************************************//**
+ * @fn	void init_slots(void)
+ *
+ * @brief	Init slot table.
+ * 			The active channels are split into two halves: slot n starts the pulses of channel n (ended by COMPA)
+ * 			and channel n+half (ended by COMPB). Additional idle slots extend the frame to frame_ms.
+ * 			Every slot takes SLOT_TIME_US, so fewer channels give a shorter frame.
+ * 			Must be called with interrupts disabled.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+void init_slots(void){
+
+	uint8_t half = (num_channels+1)/2;
+	uint8_t count = (uint8_t)((frame_ms * 1000UL + SLOT_TIME_US - 1) / SLOT_TIME_US);
+
+	if (count < half)
+	{
+		count = half;
+	}
+
+	for (uint8_t i=0;i<count;i++)
+	{
+		if (i < half)
+		{
+			set_slot(&slots[i], i, i+half);
+		}
+		else
+		{
+			set_slot(&slots[i], IDLE_CHANNEL, IDLE_CHANNEL);
+		}
+	}
+
+	num_slots = count;
+	loop = 0;
+	current_slot = &slots[0];
+
+}
+
+/**********************************************************************************************//**
+ * @fn	void apply_config(void)
+ *
+ * @brief	Rebuilds the slot table after a configuration change.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+void apply_config(void){
+
+	cli();
+	init_slots();
+	//end all running pulses
+	for (uint8_t i=0;i<NUM_SERVOS;i++)
+	{
+		*servo_pins[i].port &= ~servo_pins[i].mask;
+	}
+	sei();
+
+}
+
+#ifdef DEBUG
+
+/**********************************************************************************************//**
+ * @fn	void stats_reset(void)
+ *
+ * @brief	Resets the jitter statistics.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+void stats_reset(void){
+
+	cli();
+	for (uint8_t i=0;i<3;i++)
+	{
+		isr_latency_min[i] = 0xFFFF;
+		isr_latency_max[i] = 0;
+	}
+	for (uint8_t i=0;i<=NUM_SERVOS;i++)
+	{
+		pulse_error_min[i] = INT16_MAX;
+		pulse_error_max[i] = INT16_MIN;
+	}
+	sei();
+
+}
+
+/**********************************************************************************************//**
+ * @fn	void stats_latency(uint8_t isr, uint16_t latency)
+ *
+ * @brief	Records the entry latency of an ISR.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ *
+ * @param	isr	   	The ISR (0 = OVF, 1 = COMPA, 2 = COMPB).
+ * @param	latency	The latency in cpu cycles.
+ **************************************************************************************************/
+
+static inline void stats_latency(uint8_t isr, uint16_t latency){
+
+	if (latency < isr_latency_min[isr])
+	{
+		isr_latency_min[isr] = latency;
+	}
+	if (latency > isr_latency_max[isr])
+	{
+		isr_latency_max[isr] = latency;
+	}
+
+}
+
+/**********************************************************************************************//**
+ * @fn	void stats_pulse(uint8_t channel, int16_t error)
+ *
+ * @brief	Records the pulse width error of a channel.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ *
+ * @param	channel	The channel.
+ * @param	error  	The difference between measured and nominal pulse width in cpu cycles.
+ **************************************************************************************************/
+
+static inline void stats_pulse(uint8_t channel, int16_t error){
+
+	if (error < pulse_error_min[channel])
+	{
+		pulse_error_min[channel] = error;
+	}
+	if (error > pulse_error_max[channel])
+	{
+		pulse_error_max[channel] = error;
+	}
+
+}
+
+#endif
+
+/**********************************************************************************************//**
+ * @fn	void stats_copy(void)
+ *
+ * @brief	Copies the jitter statistics into the TWI transmit buffer (little endian).
+ * 			Without DEBUG only the number of channels is valid, all other bytes are 0xFF.
+ *
+ * @author	Alexander Miller
+ * @date	19.10.2026
+ **************************************************************************************************/
+
+void stats_copy(void){
+
+	uint8_t n = 0;
+	uint16_t value = 0;
+
+	tx_buffer[n++] = num_channels;
+	tx_buffer[n++] = num_slots;
+
+#ifdef DEBUG
+	for (uint8_t i=0;i<3;i++)
+	{
+		cli();
+		value = isr_latency_min[i];
+		sei();
+		tx_buffer[n++] = value;
+		tx_buffer[n++] = value>>8;
+		cli();
+		value = isr_latency_max[i];
+		sei();
+		tx_buffer[n++] = value;
+		tx_buffer[n++] = value>>8;
+	}
+	for (uint8_t i=0;i<NUM_SERVOS;i++)
+	{
+		cli();
+		value = pulse_error_min[i];
+		sei();
+		tx_buffer[n++] = value;
+		tx_buffer[n++] = value>>8;
+		cli();
+		value = pulse_error_max[i];
+		sei();
+		tx_buffer[n++] = value;
+		tx_buffer[n++] = value>>8;
+	}
+#else
+	(void)value;
+	while (n < TX_BUFFER_SIZE)
+	{
+		tx_buffer[n++] = 0xFF;
+	}
+#endif
+
+}
 
 /**********************************************************************************************//**
  * @fn	void init_timer(void)
@@ -184,7 +735,10 @@ void init_outputs(void){
  * @brief	Init timer.
  * 			Configure Timer0 to work in Fast-PWM-Mode with TOP at 0xFF and OCRx update at TOP.
  * 			The Prescaler is set to 64.
- * 			Time per overflow = 2,048ms 
+ * 			Time per overflow = 2,048ms
+ * 			In DEBUG builds Timer1 runs without prescaler as time base for the jitter statistics.
+ * 			Both timers are started synchronously, so an overflow of Timer0 happens every 16384 cycles
+ * 			at a Timer1 value that is a multiple of 0x4000.
  *
  * @author	Alexander Miller
  * @date	11.08.2016
@@ -192,19 +746,35 @@ void init_outputs(void){
 
 void init_timer(void){
 
+#ifdef DEBUG
+	//Halt the shared prescaler until both timers are configured
+	GTCCR = (1<<TSM) | (1<<PSRSYNC);
+	TCNT0 = 0;
+	TCNT1 = 0;
+	//TIMER1 (16bit), Normal mode, no prescaler
+	TCCR1A = 0;
+	TCCR1B = (1<<CS10);
+	stats_reset();
+#endif
+
 	//TIMER0 (8bit) , Mode 3 - Fast PWM TOP = 0xFF ,OCRx update at TOP, prescaler = 64 , Time per overflow = 0.002048 sec. = 2.048 ms (at 8Mhz Clock)
 	TCCR0A |= (1<<WGM01) | (1<<WGM00);
 	TCCR0B |= (1<<CS01) | (1<<CS00);
 
 	//Enable TIMER0 Interrupts (Compare Match A/B and Overflow)
 	TIMSK0 |= (1<<OCIE0A) | (1<<OCIE0B) | (1<<TOIE0);
+
+#ifdef DEBUG
+	//Start both timers
+	GTCCR = 0;
+#endif
 }
 
 
 /**********************************************************************************************//**
  * @fn	ISR(TIMER0_COMPA_vect)
  *
- * @brief	Interrupt Service Routine to end Servopulse 1 - 12
+ * @brief	Interrupt Service Routine to end the first servo pulse of the current slot
  *
  * @author	Alexander Miller
  * @date	11.08.2016
@@ -213,16 +783,25 @@ void init_timer(void){
 
 ISR(TIMER0_COMPA_vect){
 
-	PORTD &= ~(0xF8) ;
-	PORTC &= ~(0xFC) ;
-	PORTA &= ~(0x80) ;
+#ifdef DEBUG
+	uint16_t entry = TCNT1;
+#endif
+
+	servo_slot_t *s = current_slot;
+	*s->port_a &= s->clear_a;
+
+#ifdef DEBUG
+	uint16_t end = TCNT1;
+	stats_latency(1, (entry & 0x3FFF) - ((uint16_t)pulse_val_a << 6));
+	stats_pulse(s->channel_a, (int16_t)(end - pulse_start) - ((int16_t)pulse_val_a << 6));
+#endif
 
 }
 
 /**********************************************************************************************//**
  * @fn	ISR(TIMER0_COMPB_vect)
  *
- * @brief	Interrupt Service Routine to end Servopulse 13 - 24
+ * @brief	Interrupt Service Routine to end the second servo pulse of the current slot
  *
  * @author	Alexander Miller
  * @date	11.08.2016
@@ -231,8 +810,18 @@ ISR(TIMER0_COMPA_vect){
 
 ISR(TIMER0_COMPB_vect){
 
-	PORTA &= ~(0x7F) ;
-	PORTB &= ~(0x1F) ;
+#ifdef DEBUG
+	uint16_t entry = TCNT1;
+#endif
+
+	servo_slot_t *s = current_slot;
+	*s->port_b &= s->clear_b;
+
+#ifdef DEBUG
+	uint16_t end = TCNT1;
+	stats_latency(2, (entry & 0x3FFF) - ((uint16_t)pulse_val_b << 6));
+	stats_pulse(s->channel_b, (int16_t)(end - pulse_start) - ((int16_t)pulse_val_b << 6));
+#endif
 
 }
 
@@ -244,6 +833,7 @@ ISR(TIMER0_COMPB_vect){
  *
  * @brief	Interrupt Service Routine for timer overflow.
  * 			This ISR starts the servo signals for two servos and sets OCRx values to the length of the pulses.
+ * 			The pulses are started from the slot table, so the time until the edges is the same for every slot.
  *
  * @author	Alexander Miller
  * @date	11.08.2016
@@ -252,62 +842,36 @@ ISR(TIMER0_COMPB_vect){
 
 ISR(TIMER0_OVF_vect){
 
+#ifdef DEBUG
+	uint16_t entry = TCNT1;
+#endif
+
 	//Start pulse for two servos
-	switch (loop)
+	servo_slot_t *s = &slots[loop];
+	*s->port_a |= s->set_a;
+	*s->port_b |= s->set_b;
+	current_slot = s;
+
+#ifdef DEBUG
+	pulse_start = TCNT1;
+	pulse_val_a = next_val_a;
+	pulse_val_b = next_val_b;
+	stats_latency(0, entry & 0x3FFF);
+#endif
+
+	loop++;
+	if (loop >= num_slots)
 	{
-		case 0:
-		PORTD |= (1<<PD3); //SERVO 1
-		PORTA |= (1<<PA6); //SERVO 13
-		break;
-		case 1:
-		PORTD |= (1<<PD4); //SERVO 2
-		PORTA |= (1<<PA5); //SERVO 14
-		break;
-		case 2:
-		PORTD |= (1<<PD5); //SERVO 3
-		PORTA |= (1<<PA4); //SERVO 15
-		break;
-		case 3:
-		PORTD |= (1<<PD6); //SERVO 4
-		PORTA |= (1<<PA3); //SERVO 16
-		break;
-		case 4:
-		PORTD |= (1<<PD7); //SERVO 5
-		PORTA |= (1<<PA2); //SERVO 17
-		break;
-		case 5:
-		PORTC |= (1<<PC2); //SERVO 6
-		PORTA |= (1<<PA1); //SERVO 18
-		break;
-		case 6:
-		PORTC |= (1<<PC3); //SERVO 7
-		PORTA |= (1<<PA0); //SERVO 19
-		break;
-		case 7:
-		PORTC |= (1<<PC4); //SERVO 8
-		PORTB |= (1<<PB0); //SERVO 20
-		break;
-		case 8:
-		PORTC |= (1<<PC5); //SERVO 9
-		PORTB |= (1<<PB1); //SERVO 21
-		break;
-		case 9:
-		PORTC |= (1<<PC6); //SERVO 10
-		PORTB |= (1<<PB2); //SERVO 22
-		break;
-		case 10:
-		PORTC |= (1<<PC7); //SERVO 11
-		PORTB |= (1<<PB3); //SERVO 23
-		break;
-		case 11:
-		PORTA |= (1<<PA7); //SERVO 12
-		PORTB |= (1<<PB4); //SERVO 24
-		break;
-		default: break;
+		loop = 0;
 	}
-	loop = (loop+1)%(NUM_SERVOS/2);
-	OCR0A = data[loop];
-	OCR0B = data[loop+(NUM_SERVOS/2)];
+	s = &slots[loop];
+	OCR0A = data[s->channel_a];
+	OCR0B = data[s->channel_b];
+
+#ifdef DEBUG
+	next_val_a = OCR0A;
+	next_val_b = OCR0B;
+#endif
 
 }
 
@@ -323,11 +887,15 @@ ISR(TIMER0_OVF_vect){
 void init_all(void){
 
 	//SET INITIAL SERVO POSITION (1,5ms)
-	for (int i=0;i<NUM_SERVOS;i++)
+	for (int i=0;i<=NUM_SERVOS;i++)
 	{
 		data[i] = SERVO_STD_VAL;
 	}
 
+	init_config();
+
+	init_slots();
+
 	init_twi();
 
 	init_outputs();
@@ -355,51 +923,133 @@ int main(void)
 	unsigned char data_counter = 0;
 	unsigned char init_received = 0;
 	unsigned char twi_data = 0;
+	unsigned char tx_counter = 0;
+	unsigned char command = 0;
+	unsigned char param_counter = 0;
+	unsigned char params[NUM_SERVOS];
+	unsigned char save_pending = 0;
+	unsigned char save_step = SAVE_STEPS;
 
 	while (1)
 	{
 		//Wait for IC2 communication
-		while (!(TWCR & (1<<TWINT))){}
+		while (!(TWCR & (1<<TWINT)))
+		{
+			//save a new configuration one byte per pass, a write takes 3.4ms and must not block the bus
+			if (save_step < SAVE_STEPS && eeprom_is_ready())
+			{
+				save_config(save_step++);
+			}
+		}
 
 
 		switch(TWSR){
 			case 0x60: //Received own address and write bit, ACK returned
 			LED1_ON;
+			command = 0;
 			break;
 			case 0x70: //Received general call and write bit, ACK returned
 			LED1_ON;
+			command = 0;
 			break;
 			case 0x80: //Addressed with own address and data byte received, ACK returned
-			
+
 			case 0x90: //Addressed with general call and data byte received, ACK returned
 			LED2_ON;
 			twi_data = TWDR;
+			//parameters of a command
+			if (command != 0)
+			{
+				params[param_counter++] = twi_data;
+				if (command == CMD_CONFIG && param_counter == 2)
+				{
+					if (params[0] >= 1 && params[0] <= NUM_SERVOS && params[1] <= FRAME_MAX_MS)
+					{
+						num_channels = params[0];
+						frame_ms = params[1];
+						data_counter = 0;
+						apply_config();
+						save_pending = 1;
+					}
+					command = 0;
+				}
+				else if (command == CMD_LAYOUT && param_counter == num_channels)
+				{
+					for (uint8_t i=0;i<num_channels;i++)
+					{
+						if (params[i] < NUM_SERVOS)
+						{
+							layout[i] = params[i];
+						}
+					}
+					apply_config();
+					save_pending = 1;
+					command = 0;
+				}
+			}
+			//commands are below the minimum servo value
+			else if (twi_data == CMD_STATS_RESET)
+			{
+#ifdef DEBUG
+				stats_reset();
+#endif
+			}
+			else if (twi_data == CMD_CONFIG || twi_data == CMD_LAYOUT)
+			{
+				command = twi_data;
+				param_counter = 0;
+			}
 			//wait for 22 which indicates the first servo value
-			if (twi_data == 22)
+			else if (twi_data == 22)
 			{
 				init_received = 0;
 				data_counter = 0;
 			}
 			//wait for 11 which indicates the last servo value
-			if(twi_data == 11){
+			else if(twi_data == 11){
 				init_received = 1;
 				data_counter = 0;
 			}
 			//if 22 was received previously set the received value as servo position
-			if (init_received && twi_data != 22 && twi_data != 11)
+			else if (init_received)
 			{
 				data[data_counter] = twi_data;
-				data_counter = (data_counter+1)%NUM_SERVOS;
+				data_counter = (data_counter+1)%num_channels;
 			}
 
 			LED2_OFF;
 			break;
 			case 0xA0: //Received STOP condition
 			LED1_OFF;
+			//start saving a new configuration after its frame ended (restarts if one is being saved)
+			if (save_pending)
+			{
+				save_step = 0;
+				save_pending = 0;
+			}
+			break;
+			case 0xA8: //Received own address and read bit, ACK returned -> send statistics
+			LED1_ON;
+			stats_copy();
+			tx_counter = 0;
+			TWDR = tx_buffer[tx_counter++];
+			break;
+			case 0xB8: //Data byte transmitted, ACK received -> send next byte
+			if (tx_counter < TX_BUFFER_SIZE)
+			{
+				TWDR = tx_buffer[tx_counter++];
+			}
+			else
+			{
+				TWDR = 0xFF;
+			}
+			break;
+			case 0xC0: //Data byte transmitted, NACK received
+			case 0xC8: //Last data byte transmitted, ACK received
+			LED1_OFF;
 			break;
 		}
 		TWCR |= (1<<TWINT);
 
 	}
 }
-